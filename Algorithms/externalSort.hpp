@@ -0,0 +1,233 @@
+#ifndef EXTERNALSORT
+#define EXTERNALSORT
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <filesystem>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "merge.hpp"
+#include "sort.hpp"
+
+/**
+ * This is my external (out-of-core) sort, for binary files of fixed-size records that are bigger than memory.
+ * Phase 1 reads the file in chunks that fit in the memory budget, sorts each chunk with custom::sort, and spills it to a temporary run file.
+ * Arithmetic records are radix sorted with the second half of the budget as scratch space, so their chunks are half as long.
+ * Phase 2 streams the runs back through the loser tree used by custom::merge_k, reading and writing in large blocks.
+ * If there are too many runs to give each one a reasonably sized block, groups of runs are merged into longer runs first.
+ *
+ * Records are raw bytes on disk, so the record type must be trivially copyable. They are ordered with operator<, like the rest of the library.
+ * Errors (missing files, short reads, full disks) are thrown as std::runtime_error or std::system_error
+*/
+namespace custom{
+    struct external_sort_options{
+        size_t memory_budget = size_t(256) << 20; //Bytes used for record buffers, in both phases
+        size_t block_size = size_t(1) << 20; //Smallest read block per run during merging. Fewer bytes per run means more passes
+        size_t max_fan_in = 256; //Most runs merged (and open) at once
+        std::filesystem::path temp_directory = std::filesystem::temp_directory_path(); //Where the run files are spilled
+    };
+}
+
+namespace detail{
+    /**
+     * A temporary run file. Created exclusively in the temp directory, and removed when the object is destroyed.
+     * The file is only kept open while it is being written or merged, so the number of runs isn't limited by the open file limit
+    */
+    class runFile{
+    public:
+        explicit runFile(const std::filesystem::path& directory){
+            static std::atomic<unsigned long long> counter{0};
+            std::random_device seed;
+            for(int attempt = 0; attempt < 16 && !m_file; ++attempt){
+                m_path = directory / ("custom_sort_" + std::to_string(seed()) + "_" + std::to_string(counter++) + ".run");
+                m_file = std::fopen(m_path.string().c_str(), "wbx"); //x fails if the file exists, so two sorts can't share a run file
+            }
+            if(!m_file) throw std::system_error(errno, std::generic_category(), "Unable to create run file in " + directory.string());
+            std::setvbuf(m_file, nullptr, _IONBF, 0); //Blocks are already buffered by the sort
+        }
+
+        runFile(runFile&& other) noexcept : m_path(std::move(other.m_path)), m_file(std::exchange(other.m_file, nullptr)) { other.m_path.clear(); }
+        runFile(const runFile&) = delete;
+        runFile& operator=(const runFile&) = delete;
+        runFile& operator=(runFile&&) = delete;
+
+        ~runFile(){
+            if(m_file) std::fclose(m_file);
+            if(m_path.empty()) return; //Moved from
+            std::error_code ignored;
+            std::filesystem::remove(m_path, ignored);
+        }
+
+        std::FILE* get() const noexcept { return m_file; }
+
+        /**
+         * Closes the file, making sure everything written made it to disk
+        */
+        void close(){
+            if(!m_file) return;
+            const int result = std::fclose(std::exchange(m_file, nullptr));
+            if(result != 0) throw std::runtime_error("Unable to write run file " + m_path.string());
+        }
+
+        /**
+         * Reopens the run from the start so it can be merged
+        */
+        void open_for_reading(){
+            close();
+            m_file = std::fopen(m_path.string().c_str(), "rb");
+            if(!m_file) throw std::system_error(errno, std::generic_category(), "Unable to open run file " + m_path.string());
+            std::setvbuf(m_file, nullptr, _IONBF, 0);
+        }
+
+    private:
+        std::filesystem::path m_path;
+        std::FILE* m_file = nullptr;
+    };
+
+    /**
+     * Writes the whole block or throws
+    */
+    template<typename Record>
+    void write_records(std::FILE* file, const Record* records, size_t count){
+        if(count != 0 && std::fwrite(records, sizeof(Record), count, file) != count) throw std::runtime_error("Unable to write sorted records");
+    }
+
+    /**
+     * Reads up to @param count records, throwing if the file holds a partial record
+    */
+    template<typename Record>
+    size_t read_records(std::FILE* file, Record* records, size_t count){
+        const size_t read = std::fread(records, 1, count * sizeof(Record), file);
+        if(std::ferror(file)) throw std::runtime_error("Unable to read records");
+        if(read % sizeof(Record) != 0) throw std::runtime_error("File size is not a multiple of the record size");
+        return read / sizeof(Record);
+    }
+
+    /**
+     * A run being merged. Reads the run one block at a time into its slice of the merge buffer.
+     * Has the empty/front/pop interface the loser tree expects
+    */
+    template<typename Record>
+    class runReader{
+    public:
+        runReader(std::FILE* file, Record* buffer, size_t capacity) : m_file(file), m_buffer(buffer), m_capacity(capacity) { refill(); }
+
+        bool empty() const noexcept { return m_position == m_count; }
+        const Record& front() const noexcept { return m_buffer[m_position]; }
+        void pop(){
+            if(++m_position == m_count) refill();
+        }
+
+    private:
+        std::FILE* m_file;
+        Record* m_buffer;
+        size_t m_capacity;
+        size_t m_position = 0;
+        size_t m_count = 0;
+
+        void refill(){
+            m_count = detail::read_records(m_file, m_buffer, m_capacity);
+            m_position = 0;
+        }
+    };
+
+    /**
+     * Merges @param runs into @param output through a loser tree. @param buffer is split evenly between the runs and the output
+    */
+    template<typename Record>
+    void merge_runs_to_file(std::vector<runFile>& runs, size_t first, size_t last, std::FILE* output, Record* buffer, size_t buffer_records){
+        const size_t block = buffer_records / (last - first + 1);
+        std::vector<runReader<Record>> readers;
+        readers.reserve(last - first);
+        for(size_t i = first; i < last; ++i){
+            runs[i].open_for_reading();
+            readers.emplace_back(runs[i].get(), buffer + (i - first) * block, block);
+        }
+
+        Record* out = buffer + (last - first) * block;
+        size_t pending = 0;
+        detail::loserTree<runReader<Record>> tree(readers);
+        while(!tree.empty()){
+            out[pending++] = tree.top();
+            tree.pop();
+            if(pending == block){
+                detail::write_records(output, out, pending);
+                pending = 0;
+            }
+        }
+        detail::write_records(output, out, pending);
+        for(size_t i = first; i < last; ++i) runs[i].close();
+    }
+}
+
+namespace custom{
+    /**
+     * Sorts the fixed-size records in @param input and writes them to @param output, using about options.memory_budget bytes of memory.
+     * The input and output may be the same file
+    */
+    template<typename Record>
+    void external_sort(const std::filesystem::path& input, const std::filesystem::path& output, const external_sort_options& options = {}){
+        static_assert(std::is_trivially_copyable_v<Record>, "Records are read and written as raw bytes");
+        const size_t buffer_records = options.memory_budget / sizeof(Record);
+        const size_t block_records = std::max<size_t>(1, options.block_size / sizeof(Record));
+        if(buffer_records < 3) throw std::invalid_argument("Memory budget must hold at least 3 records");
+        std::unique_ptr<Record[]> buffer = std::make_unique_for_overwrite<Record[]>(buffer_records); //Reused for chunks in phase 1 and blocks in phase 2
+        //Arithmetic records are radix sorted, which needs a scratch buffer as big as the chunk. The second half of the buffer is that scratch,
+        //rather than letting custom::sort allocate one on top of the budget
+        const size_t chunk_records = detail::radix_sortable<Record> ? buffer_records / 2 : buffer_records;
+
+        //Phase 1: sort chunks that fit in memory and spill them as runs
+        std::vector<detail::runFile> runs;
+        {
+            std::unique_ptr<std::FILE, int(*)(std::FILE*)> in(std::fopen(input.string().c_str(), "rb"), &std::fclose);
+            if(!in) throw std::system_error(errno, std::generic_category(), "Unable to open " + input.string());
+            while(true){
+                const size_t count = detail::read_records(in.get(), buffer.get(), chunk_records);
+                if(count == 0) break;
+                if constexpr (detail::radix_sortable<Record>){
+                    if(count >= size_t(detail::radix_sort_threshold)) detail::radix_sort(buffer.get(), buffer.get() + count, buffer.get() + chunk_records);
+                    else custom::sort(buffer.get(), buffer.get() + count); //Too small for the radix sort, so custom::sort doesn't allocate either
+                }
+                else custom::sort(buffer.get(), buffer.get() + count);
+                if(runs.empty() && count < chunk_records){ //A short read means the whole file fit in memory, so skip the merge
+                    std::unique_ptr<std::FILE, int(*)(std::FILE*)> out(std::fopen(output.string().c_str(), "wb"), &std::fclose);
+                    if(!out) throw std::system_error(errno, std::generic_category(), "Unable to open " + output.string());
+                    detail::write_records(out.get(), buffer.get(), count);
+                    if(std::fclose(out.release()) != 0) throw std::runtime_error("Unable to write " + output.string());
+                    return;
+                }
+                runs.emplace_back(options.temp_directory);
+                detail::write_records(runs.back().get(), buffer.get(), count);
+                runs.back().close();
+            }
+        }
+
+        //Phase 2: merge the runs. Each run (and the output) needs at least one block, so cap how many are merged at once
+        const size_t blocks = buffer_records / block_records;
+        const size_t fan_in = std::max<size_t>(2, std::min(options.max_fan_in, blocks > 0 ? blocks - 1 : 0));
+        while(runs.size() > fan_in){ //Too many runs for one pass, merge groups of them into longer runs
+            std::vector<detail::runFile> merged;
+            for(size_t first = 0; first < runs.size(); first += fan_in){
+                const size_t last = std::min(first + fan_in, runs.size());
+                merged.emplace_back(options.temp_directory);
+                detail::merge_runs_to_file(runs, first, last, merged.back().get(), buffer.get(), buffer_records);
+                merged.back().close();
+            }
+            runs = std::move(merged);
+        }
+
+        std::unique_ptr<std::FILE, int(*)(std::FILE*)> out(std::fopen(output.string().c_str(), "wb"), &std::fclose);
+        if(!out) throw std::system_error(errno, std::generic_category(), "Unable to open " + output.string());
+        std::setvbuf(out.get(), nullptr, _IONBF, 0);
+        if(!runs.empty()) detail::merge_runs_to_file(runs, 0, runs.size(), out.get(), buffer.get(), buffer_records);
+        if(std::fclose(out.release()) != 0) throw std::runtime_error("Unable to write " + output.string());
+    }
+}
+#endif //EXTERNALSORT
@@ -1,10 +1,192 @@
 #ifndef MERGE
 #define MERGE
+#include <algorithm>
+#include <iterator>
+#include <ranges>
+#include <tuple>
+#include <utility>
+#include <vector>
+#include "threadPool.hpp"
 
 /*
  * custom::merge merges two sorted vectors together.
  * Attempting to merge two unsorted vectors will result in UB (undefined behavior)
 */
+namespace detail{
+    /**
+     * Galloping (exponential) search. Checks first[0], first[1], first[3], first[7], ... until it overshoots, then binary searches the last gap.
+     * Finds the answer in O(log k) comparisons where k is the distance to it, which is what makes galloping cheap when k is small.
+     * Returns the first item > value
+    */
+    template<typename Iter, typename T>
+    constexpr Iter gallop_upper_bound(Iter first, Iter last, const T& value){
+        typename std::iterator_traits<Iter>::difference_type lo = 0, step = 1;
+        const auto length = last - first;
+        while(lo + step <= length && !(value < *(first + (lo + step - 1)))){ //first[lo + step - 1] <= value, keep doubling
+            lo += step;
+            step *= 2;
+        }
+        const auto hi = lo + step < length ? lo + step : length;
+        return std::upper_bound(first + lo, first + hi, value);
+    }
+
+    /**
+     * Galloping search that returns the first item >= value
+    */
+    template<typename Iter, typename T>
+    constexpr Iter gallop_lower_bound(Iter first, Iter last, const T& value){
+        typename std::iterator_traits<Iter>::difference_type lo = 0, step = 1;
+        const auto length = last - first;
+        while(lo + step <= length && *(first + (lo + step - 1)) < value){
+            lo += step;
+            step *= 2;
+        }
+        const auto hi = lo + step < length ? lo + step : length;
+        return std::lower_bound(first + lo, first + hi, value);
+    }
+
+    /**
+     * The galloping merge loop. Stops as soon as either input runs out and returns where each input and the output stopped,
+     * so callers merging in place can skip copying a tail that is already where it belongs
+    */
+    template<typename InputIterator1, typename InputIterator2, class OutputIterator>
+    constexpr std::tuple<InputIterator1, InputIterator2, OutputIterator>
+    gallop_merge_loop(InputIterator1 first1, InputIterator1 last1, InputIterator2 first2, InputIterator2 last2, OutputIterator d_first){
+        constexpr size_t min_gallop = 7; //How many wins in a row before it is worth searching instead of comparing one at a time
+        size_t wins1 = 0, wins2 = 0;
+        while(first1 != last1 && first2 != last2){
+            if(*first2 < *first1){
+                *d_first = *first2;
+                ++first2;
+                ++wins2;
+                wins1 = 0;
+            }
+            else{ //Ties go to the first range, which keeps the merge stable
+                *d_first = *first1;
+                ++first1;
+                ++wins1;
+                wins2 = 0;
+            }
+            ++d_first;
+
+            if(wins1 >= min_gallop){ //Range 1 keeps winning. Copy every item that is <= the head of range 2 in one go
+                InputIterator1 run_end = detail::gallop_upper_bound(first1, last1, *first2);
+                d_first = std::copy(first1, run_end, d_first);
+                first1 = run_end;
+                wins1 = 0;
+            }
+            else if(wins2 >= min_gallop){ //Range 2 keeps winning. Copy every item that is < the head of range 1 in one go
+                InputIterator2 run_end = detail::gallop_lower_bound(first2, last2, *first1);
+                d_first = std::copy(first2, run_end, d_first);
+                first2 = run_end;
+                wins2 = 0;
+            }
+        }
+        return {first1, first2, d_first};
+    }
+
+    /**
+     * Merge path search. Finds how many of the first @param diagonal items of the merged output come from the first range.
+     * Walking the merge as a path through the grid of (items taken from range 1, items taken from range 2), the output position is a diagonal of the grid,
+     * and the path crosses it exactly once. That crossing is found with a binary search along the diagonal, in O(log n) comparisons.
+     * Ties go to the first range, matching custom::merge
+    */
+    template<typename InputIterator, typename Distance>
+    constexpr Distance merge_path(InputIterator first1, Distance length1, InputIterator first2, Distance length2, Distance diagonal){
+        Distance lo = diagonal > length2 ? diagonal - length2 : 0;
+        Distance hi = diagonal < length1 ? diagonal : length1;
+        while(lo < hi){
+            const Distance mid = lo + (hi - lo) / 2;
+            if(*(first2 + (diagonal - mid - 1)) < *(first1 + mid)) hi = mid; //first1[mid] comes after first2[diagonal - mid - 1], so fewer items come from range 1
+            else lo = mid + 1;
+        }
+        return lo;
+    }
+
+    /**
+     * A tournament tree of losers, used for k-way merging.
+     * Each source is a sorted stream with empty(), front() and pop(). The leaves of the tree are the sources' front items, every inner node remembers
+     * the loser of the match played there, and the overall winner (the smallest front item) sits on top.
+     * After the winner is popped, only the matches on the path from its leaf to the root are replayed against the stored losers,
+     * so each item costs about log2(k) comparisons.
+     * Ties go to the source with the lower index, which keeps the merge stable
+    */
+    template<class Source>
+    class loserTree{
+    public:
+        explicit loserTree(std::vector<Source>& sources) : m_sources(sources), m_tree(sources.empty() ? 1 : sources.size(), 0) {
+            if(m_sources.size() > 1) m_tree[0] = build(1);
+        }
+
+        /**
+         * Returns true once every source is empty
+        */
+        bool empty() const { return m_sources.empty() || m_sources[m_tree[0]].empty(); }
+
+        /**
+         * Returns the smallest front item of all the sources
+        */
+        decltype(auto) top() const { return m_sources[m_tree[0]].front(); }
+
+        /**
+         * Returns the index of the source holding the smallest front item
+        */
+        size_t top_source() const noexcept { return m_tree[0]; }
+
+        /**
+         * Pops the smallest item from its source and replays its path up the tree
+        */
+        void pop(){
+            size_t winner = m_tree[0];
+            m_sources[winner].pop();
+            for(size_t node = (winner + m_sources.size()) / 2; node > 0; node /= 2){
+                if(beats(m_tree[node], winner)) std::swap(m_tree[node], winner); //The stored loser wins this match, so it moves up and the old winner stays behind
+            }
+            m_tree[0] = winner;
+        }
+
+    private:
+        std::vector<Source>& m_sources;
+        std::vector<size_t> m_tree; //m_tree[0] is the winner, m_tree[1..k) are the losers. Leaves are implicit at k + source index
+
+        /**
+         * Returns true if source a's front item comes before source b's. Empty sources lose every match
+        */
+        bool beats(size_t a, size_t b) const {
+            if(m_sources[a].empty()) return false;
+            if(m_sources[b].empty()) return true;
+            if(m_sources[b].front() < m_sources[a].front()) return false;
+            if(m_sources[a].front() < m_sources[b].front()) return true;
+            return a < b;
+        }
+
+        /**
+         * Plays every match below @param node, storing the losers. Returns the winner
+        */
+        size_t build(size_t node){
+            const size_t k = m_sources.size();
+            if(node >= k) return node - k; //A leaf
+            size_t left = build(2 * node);
+            size_t right = build(2 * node + 1);
+            if(beats(right, left)) std::swap(left, right);
+            m_tree[node] = right;
+            return left;
+        }
+    };
+
+    /**
+     * Adapts an iterator range to the source interface the loser tree expects
+    */
+    template<typename Iter>
+    struct rangeSource{
+        Iter first;
+        Iter last;
+        bool empty() const { return first == last; }
+        decltype(auto) front() const { return *first; }
+        void pop() { ++first; }
+    };
+}
+
 namespace custom{
     template<typename InputIterator, class OutputIterator>
     /**
@@ -29,5 +211,80 @@ namespace custom{
         }
         return std::copy(first2, last2, d_first); //Copy the remaining elements from vector 2 to the new vector
     }
+
+    /**
+     * Parallel merge. Use custom::execution::par for the shared pool, or custom::execution::par.on(pool) to pick the pool.
+     * The output is cut into equal slices, and a merge path search finds where each slice starts in both inputs.
+     * Every slice is then merged serially on its own worker into its own part of d_first, so no two workers write the same memory.
+     * All iterators must be random access. Falls back to the serial merge when the output is no bigger than the policy's grain
+    */
+    template<typename InputIterator, class OutputIterator>
+    OutputIterator merge(const execution::parallel_policy& policy, InputIterator first1, InputIterator last1, InputIterator first2, InputIterator last2, OutputIterator d_first){
+        typedef typename std::iterator_traits<InputIterator>::difference_type DistanceType;
+        const DistanceType length1 = last1 - first1;
+        const DistanceType length2 = last2 - first2;
+        const DistanceType total = length1 + length2;
+        threadPool& pool = policy.get_pool();
+        const DistanceType grain = static_cast<DistanceType>(policy.grain == 0 ? 1 : policy.grain);
+        if(total <= grain || pool.size() < 2) return custom::merge(first1, last1, first2, last2, d_first);
+
+        const DistanceType max_slices = static_cast<DistanceType>(pool.size()) * 4; //A few slices per worker so a slow one doesn't hold everyone up
+        const DistanceType slices = std::min((total + grain - 1) / grain, max_slices);
+
+        taskGroup group(pool);
+        auto merge_slice = [=](DistanceType slice){
+            const DistanceType start = total * slice / slices;
+            const DistanceType end = total * (slice + 1) / slices;
+            const DistanceType i_start = detail::merge_path(first1, length1, first2, length2, start);
+            const DistanceType i_end = detail::merge_path(first1, length1, first2, length2, end);
+            custom::merge(first1 + i_start, first1 + i_end, first2 + (start - i_start), first2 + (end - i_end), d_first + start);
+        };
+        for(DistanceType slice = 1; slice < slices; ++slice){
+            group.run([merge_slice, slice]{ merge_slice(slice); });
+        }
+        merge_slice(0); //The calling thread takes the first slice itself
+        group.wait();
+        return d_first + total;
+    }
+
+    /**
+     * K-way merge. Merges every sorted range in @param runs into one sorted output in a single pass, using a loser tree.
+     * Each item costs about log2(k) comparisons, instead of the O(log k) full passes over the data that repeated pairwise merges need.
+     * @param runs is any range of ranges, e.g. std::vector<std::vector<T>>, or std::vector<std::span<const T>> for ranges that live elsewhere.
+     * Stable: equal items keep the order of the ranges they came from
+    */
+    template<class RangeOfRanges, class OutputIterator>
+    OutputIterator merge_k(RangeOfRanges&& runs, OutputIterator d_first){
+        using Iter = decltype(std::ranges::begin(*std::ranges::begin(runs)));
+        std::vector<detail::rangeSource<Iter>> sources;
+        for(auto&& run : runs){
+            sources.push_back({std::ranges::begin(run), std::ranges::end(run)});
+        }
+        if(sources.empty()) return d_first;
+        if(sources.size() == 1) return std::copy(sources[0].first, sources[0].last, d_first);
+        if(sources.size() == 2) return custom::merge(sources[0].first, sources[0].last, sources[1].first, sources[1].last, d_first);
+
+        detail::loserTree<detail::rangeSource<Iter>> tree(sources);
+        while(!tree.empty()){
+            *d_first = tree.top();
+            ++d_first;
+            tree.pop();
+        }
+        return d_first;
+    }
+
+    /**
+     * A galloping version of custom::merge, used by custom::stable_sort.
+     * Merges one item at a time until one range has won min_gallop times in a row, then uses a galloping search to find
+     * how many more items that range wins and copies them all at once. Inputs made of long interleaved runs are merged in close to
+     * O(runs * log n) comparisons instead of O(n).
+     * Like custom::merge it is stable: equal items from the first range come before those from the second. Both ranges must be random access
+    */
+    template<typename InputIterator1, typename InputIterator2, class OutputIterator>
+    OutputIterator gallop_merge(InputIterator1 first1, InputIterator1 last1, InputIterator2 first2, InputIterator2 last2, OutputIterator d_first){
+        std::tie(first1, first2, d_first) = detail::gallop_merge_loop(first1, last1, first2, last2, d_first);
+        d_first = std::copy(first1, last1, d_first); //At most one of the two ranges still has items
+        return std::copy(first2, last2, d_first);
+    }
 }
 #endif //MERGE
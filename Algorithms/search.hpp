@@ -0,0 +1,324 @@
+#ifndef SEARCH
+#define SEARCH
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define CUSTOM_SEARCH_X86 1
+#include <immintrin.h>
+#endif
+
+/**
+ * Searching, both unsorted and sorted.
+ *
+ * custom::find, custom::count and custom::contains scan a range for a value. For arithmetic types in contiguous memory the scan uses SIMD kernels,
+ * which compare a whole register of items (32 bytes with AVX2, 16 with SSE2) per instruction and only branch once every 4 registers.
+ * As with the sorting networks, the instruction set is picked at runtime, and other types, iterators and CPUs use the plain loop.
+ *
+ * For ranges sorted with custom::sort there is custom::branchless_lower_bound, a binary search whose only branch is the loop itself
+ * (the halving step compiles to a conditional move), and custom::eytzingerIndex, a copy of the sorted range laid out in BFS order.
+ * In that layout the next few levels of the search sit next to each other in memory, so they can be prefetched while the current level is compared.
+ * It pays off once the range no longer fits in cache, and costs one copy of the range
+*/
+namespace detail{
+    /**
+     * Types the kernels can search: 1, 2, 4 and 8 byte integers (other than bool), and IEEE float/double.
+     * Floats are compared the way == compares them, so NaN never matches and -0.0 matches 0.0
+    */
+    template<typename T>
+    concept simd_searchable = (std::is_integral_v<T> && !std::is_same_v<T, bool> && (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8))
+                           || (std::is_floating_point_v<T> && std::numeric_limits<T>::is_iec559 && (sizeof(T) == 4 || sizeof(T) == 8));
+
+    /**
+     * The search kernels for the current CPU
+    */
+    template<typename T>
+    struct search_kernel{
+        const T* (*find)(const T* first, const T* last, T value);
+        size_t (*count)(const T* first, const T* last, T value);
+    };
+
+#ifdef CUSTOM_SEARCH_X86
+    //Each instruction set gets a matcher<Float, Bytes> traits class with broadcast (the value into every lane) and match (compare a register's worth
+    //of items with it, returning the byte mask of the equal lanes)
+    namespace avx2{
+#define CUSTOM_SEARCH_AVX2 __attribute__((target("avx2,popcnt"), always_inline)) static inline
+
+        template<bool Float, size_t Bytes> struct matcher;
+
+        template<size_t Bytes>
+        struct matcher<false, Bytes>{
+            using reg = __m256i;
+            static constexpr size_t bytes = 32;
+            template<typename T>
+            CUSTOM_SEARCH_AVX2 reg broadcast(T v){
+                if constexpr (Bytes == 1) return _mm256_set1_epi8(char(v));
+                else if constexpr (Bytes == 2) return _mm256_set1_epi16(short(v));
+                else if constexpr (Bytes == 4) return _mm256_set1_epi32(int(v));
+                else return _mm256_set1_epi64x((long long)(v));
+            }
+            template<typename T>
+            CUSTOM_SEARCH_AVX2 uint32_t match(const T* p, reg needle){
+                const reg items = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+                if constexpr (Bytes == 1) return uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(items, needle)));
+                else if constexpr (Bytes == 2) return uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi16(items, needle)));
+                else if constexpr (Bytes == 4) return uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi32(items, needle)));
+                else return uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi64(items, needle)));
+            }
+        };
+
+        template<> struct matcher<true, 4>{
+            using reg = __m256;
+            static constexpr size_t bytes = 32;
+            CUSTOM_SEARCH_AVX2 reg broadcast(float v){ return _mm256_set1_ps(v); }
+            CUSTOM_SEARCH_AVX2 uint32_t match(const float* p, reg needle){
+                return uint32_t(_mm256_movemask_epi8(_mm256_castps_si256(_mm256_cmp_ps(_mm256_loadu_ps(p), needle, _CMP_EQ_OQ))));
+            }
+        };
+
+        template<> struct matcher<true, 8>{
+            using reg = __m256d;
+            static constexpr size_t bytes = 32;
+            CUSTOM_SEARCH_AVX2 reg broadcast(double v){ return _mm256_set1_pd(v); }
+            CUSTOM_SEARCH_AVX2 uint32_t match(const double* p, reg needle){
+                return uint32_t(_mm256_movemask_epi8(_mm256_castpd_si256(_mm256_cmp_pd(_mm256_loadu_pd(p), needle, _CMP_EQ_OQ))));
+            }
+        };
+#undef CUSTOM_SEARCH_AVX2
+    }
+
+    namespace sse2{
+#define CUSTOM_SEARCH_SSE2 __attribute__((target("sse2"), always_inline)) static inline
+
+        template<bool Float, size_t Bytes> struct matcher;
+
+        template<size_t Bytes>
+        struct matcher<false, Bytes>{
+            using reg = __m128i;
+            static constexpr size_t bytes = 16;
+            template<typename T>
+            CUSTOM_SEARCH_SSE2 reg broadcast(T v){
+                if constexpr (Bytes == 1) return _mm_set1_epi8(char(v));
+                else if constexpr (Bytes == 2) return _mm_set1_epi16(short(v));
+                else if constexpr (Bytes == 4) return _mm_set1_epi32(int(v));
+                else return _mm_set1_epi64x((long long)(v));
+            }
+            template<typename T>
+            CUSTOM_SEARCH_SSE2 uint32_t match(const T* p, reg needle){
+                const reg items = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+                if constexpr (Bytes == 1) return uint32_t(_mm_movemask_epi8(_mm_cmpeq_epi8(items, needle)));
+                else if constexpr (Bytes == 2) return uint32_t(_mm_movemask_epi8(_mm_cmpeq_epi16(items, needle)));
+                else if constexpr (Bytes == 4) return uint32_t(_mm_movemask_epi8(_mm_cmpeq_epi32(items, needle)));
+                else{ //SSE2 has no 64 bit compare: both 32 bit halves have to match
+                    const reg halves = _mm_cmpeq_epi32(items, needle);
+                    return uint32_t(_mm_movemask_epi8(_mm_and_si128(halves, _mm_shuffle_epi32(halves, _MM_SHUFFLE(2, 3, 0, 1)))));
+                }
+            }
+        };
+
+        template<> struct matcher<true, 4>{
+            using reg = __m128;
+            static constexpr size_t bytes = 16;
+            CUSTOM_SEARCH_SSE2 reg broadcast(float v){ return _mm_set1_ps(v); }
+            CUSTOM_SEARCH_SSE2 uint32_t match(const float* p, reg needle){
+                return uint32_t(_mm_movemask_epi8(_mm_castps_si128(_mm_cmpeq_ps(_mm_loadu_ps(p), needle))));
+            }
+        };
+
+        template<> struct matcher<true, 8>{
+            using reg = __m128d;
+            static constexpr size_t bytes = 16;
+            CUSTOM_SEARCH_SSE2 reg broadcast(double v){ return _mm_set1_pd(v); }
+            CUSTOM_SEARCH_SSE2 uint32_t match(const double* p, reg needle){
+                return uint32_t(_mm_movemask_epi8(_mm_castpd_si128(_mm_cmpeq_pd(_mm_loadu_pd(p), needle))));
+            }
+        };
+#undef CUSTOM_SEARCH_SSE2
+    }
+
+    //The loops are the same for every instruction set, but have to be compiled once per target
+#define CUSTOM_SEARCH_NAMESPACE avx2
+#define CUSTOM_SEARCH_TARGET "avx2,popcnt"
+#include "searchKernel.hpp"
+#undef CUSTOM_SEARCH_NAMESPACE
+#undef CUSTOM_SEARCH_TARGET
+
+#define CUSTOM_SEARCH_NAMESPACE sse2
+#define CUSTOM_SEARCH_TARGET "sse2"
+#include "searchKernel.hpp"
+#undef CUSTOM_SEARCH_NAMESPACE
+#undef CUSTOM_SEARCH_TARGET
+#endif //CUSTOM_SEARCH_X86
+
+    /**
+     * Returns the best search kernel the CPU supports for T, or nullptr if there is none. The CPU is only checked once per type
+    */
+    template<typename T>
+    const search_kernel<T>* search_kernel_for() noexcept {
+#ifdef CUSTOM_SEARCH_X86
+        static const search_kernel<T>* const kernel = []() -> const search_kernel<T>* {
+            __builtin_cpu_init();
+            if(__builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt")) return &avx2::searcher<T>;
+            if(__builtin_cpu_supports("sse2")) return &sse2::searcher<T>;
+            return nullptr;
+        }();
+        return kernel;
+#else
+        return nullptr;
+#endif
+    }
+
+    /**
+     * True when searching [Iter, Iter) for a U can go through the kernels: the items are searchable, contiguous, and the value is the same type
+     * (searching with another type keeps the usual arithmetic conversions of ==, so it uses the plain loop)
+    */
+    template<class Iter, class U>
+    concept kernel_searchable = std::contiguous_iterator<Iter> && simd_searchable<std::iter_value_t<Iter>>
+                             && std::is_same_v<std::remove_cvref_t<U>, std::iter_value_t<Iter>>;
+}
+
+namespace custom{
+    /**
+     * Returns an iterator to the first object in [first, last) equal to @param value, or last if there is none
+    */
+    template<class Iter, class U>
+    Iter find(Iter first, Iter last, const U& value){
+        if constexpr (detail::kernel_searchable<Iter, U>){
+            using T = std::iter_value_t<Iter>;
+            if(const detail::search_kernel<T>* kernel = detail::search_kernel_for<T>()){
+                const T* begin = std::to_address(first);
+                return first + (kernel->find(begin, begin + (last - first), value) - begin);
+            }
+        }
+        for(; first != last; ++first){
+            if(*first == value) return first;
+        }
+        return last;
+    }
+
+    /**
+     * Returns the number of objects in [first, last) equal to @param value
+    */
+    template<class Iter, class U>
+    size_t count(Iter first, Iter last, const U& value){
+        if constexpr (detail::kernel_searchable<Iter, U>){
+            using T = std::iter_value_t<Iter>;
+            if(const detail::search_kernel<T>* kernel = detail::search_kernel_for<T>()){
+                const T* begin = std::to_address(first);
+                return kernel->count(begin, begin + (last - first), value);
+            }
+        }
+        size_t count = 0;
+        for(; first != last; ++first) count += *first == value;
+        return count;
+    }
+
+    /**
+     * Returns true if some object in [first, last) is equal to @param value
+    */
+    template<class Iter, class U>
+    bool contains(Iter first, Iter last, const U& value){
+        return custom::find(first, last, value) != last;
+    }
+
+    /**
+     * Returns an iterator to the first object in the sorted range [first, last) that is not less than @param value, or last if there is none.
+     * Each step halves the range without branching on the comparison, which the compiler turns into a conditional move,
+     * so there are no mispredictions on random probes
+    */
+    template<class Iter, class U, class Compare = std::less<>>
+    Iter branchless_lower_bound(Iter first, Iter last, const U& value, Compare comp = Compare()){
+        auto length = last - first;
+        if(length == 0) return last;
+        while(length > 1){
+            const auto half = length / 2;
+            first += comp(first[half], value) ? half : 0; //The answer is never before first[half] when it is less than value
+            length -= half;
+        }
+        return first + comp(*first, value);
+    }
+
+    /**
+     * Returns true if the sorted range [first, last) holds an object equivalent to @param value
+    */
+    template<class Iter, class U, class Compare = std::less<>>
+    bool branchless_binary_search(Iter first, Iter last, const U& value, Compare comp = Compare()){
+        Iter it = custom::branchless_lower_bound(first, last, value, comp);
+        return it != last && !comp(value, *it);
+    }
+
+    /**
+     * A search index over a sorted range, stored in Eytzinger (BFS) order: the root at index 1 and the children of item k at 2k and 2k + 1.
+     * The index holds a copy of the items, so it stays valid when the original range changes, but doesn't see the changes.
+     * Lookups are O(log n) like a binary search, but walk memory front to back and prefetch the block of items 4 levels down while comparing,
+     * which hides most of the cache misses a plain binary search takes on large ranges
+    */
+    template<typename T, class Compare = std::less<T>>
+    class eytzingerIndex{
+    public:
+        eytzingerIndex() = default;
+
+        /**
+         * Range constructor
+         * Builds the index from [first, last), which must be sorted by @param comp (e.g. with custom::sort)
+        */
+        template<std::forward_iterator Iter>
+        eytzingerIndex(Iter first, Iter last, Compare comp = Compare()) : m_size(size_t(std::distance(first, last))), m_comp(comp) {
+            m_items = std::make_unique<T[]>(m_size + 1); //Index 0 is unused, so the children of k are always 2k and 2k + 1
+            fill(first, 1);
+        }
+
+        /**
+         * Returns a pointer to the smallest item in the index that is not less than @param value, or nullptr if every item is less
+        */
+        const T* lower_bound(const T& value) const {
+            size_t k = 1;
+            while(k <= m_size){
+#if defined(__GNUC__) || defined(__clang__)
+                __builtin_prefetch(m_items.get() + std::min(k * prefetch_stride, m_size)); //Items 16k..16k+15 are k's descendants 4 levels down
+#endif
+                k = 2 * k + m_comp(m_items[k], value);
+            }
+            k >>= std::countr_one(k) + 1; //Undo the right turns taken after the last left turn, which lands on the answer
+            return k == 0 ? nullptr : &m_items[k];
+        }
+
+        /**
+         * Returns true if the index holds an item equivalent to @param value
+        */
+        bool contains(const T& value) const {
+            const T* item = lower_bound(value);
+            return item && !m_comp(value, *item);
+        }
+
+        size_t size() const noexcept { return m_size; }
+        bool isEmpty() const noexcept { return m_size == 0; }
+
+    private:
+        static constexpr size_t prefetch_stride = 16;
+        std::unique_ptr<T[]> m_items;
+        size_t m_size = 0;
+        [[no_unique_address]] Compare m_comp;
+
+        /**
+         * Fills the subtree rooted at @param k with an in-order walk, which takes the sorted items in order
+        */
+        template<class Iter>
+        void fill(Iter& it, size_t k){
+            if(k > m_size) return;
+            fill(it, 2 * k);
+            m_items[k] = *it;
+            ++it;
+            fill(it, 2 * k + 1);
+        }
+    };
+}
+#endif //SEARCH
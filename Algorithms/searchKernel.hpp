@@ -0,0 +1,55 @@
+//No include guard: search.hpp includes this file once per instruction set,
+//with CUSTOM_SEARCH_NAMESPACE naming the namespace holding that set's matcher traits and CUSTOM_SEARCH_TARGET naming the target
+
+/**
+ * The find and count loops, written against the matcher traits of one instruction set.
+ * matcher::match compares a register's worth of items with the broadcast value and returns a bit mask with sizeof(T) bits set per equal item,
+ * so the index of the first match is countr_zero(mask) / sizeof(T), and the number of matches is popcount(mask) / sizeof(T)
+*/
+namespace CUSTOM_SEARCH_NAMESPACE{
+    /**
+     * Returns a pointer to the first item in [first, last) equal to value, or last if there is none
+    */
+    template<typename T>
+    __attribute__((target(CUSTOM_SEARCH_TARGET))) const T* find_block(const T* first, const T* last, T value){
+        using M = matcher<std::is_floating_point_v<T>, sizeof(T)>;
+        constexpr std::ptrdiff_t k = M::bytes / sizeof(T);
+        const typename M::reg needle = M::broadcast(value);
+        while(last - first >= 4 * k){ //Four registers per step, so a miss costs one branch for 4 registers
+            const uint32_t m0 = M::match(first, needle), m1 = M::match(first + k, needle);
+            const uint32_t m2 = M::match(first + 2 * k, needle), m3 = M::match(first + 3 * k, needle);
+            if(m0 | m1 | m2 | m3){
+                if(m0) return first + __builtin_ctz(m0) / sizeof(T);
+                if(m1) return first + k + __builtin_ctz(m1) / sizeof(T);
+                if(m2) return first + 2 * k + __builtin_ctz(m2) / sizeof(T);
+                return first + 3 * k + __builtin_ctz(m3) / sizeof(T);
+            }
+            first += 4 * k;
+        }
+        for(; last - first >= k; first += k){
+            if(const uint32_t m = M::match(first, needle)) return first + __builtin_ctz(m) / sizeof(T);
+        }
+        for(; first != last; ++first){
+            if(*first == value) return first;
+        }
+        return last;
+    }
+
+    /**
+     * Returns the number of items in [first, last) equal to value
+    */
+    template<typename T>
+    __attribute__((target(CUSTOM_SEARCH_TARGET))) size_t count_block(const T* first, const T* last, T value){
+        using M = matcher<std::is_floating_point_v<T>, sizeof(T)>;
+        constexpr std::ptrdiff_t k = M::bytes / sizeof(T);
+        const typename M::reg needle = M::broadcast(value);
+        size_t bits = 0;
+        for(; last - first >= k; first += k) bits += __builtin_popcount(M::match(first, needle));
+        size_t count = bits / sizeof(T);
+        for(; first != last; ++first) count += *first == value;
+        return count;
+    }
+
+    template<typename T>
+    inline constexpr search_kernel<T> searcher{&find_block<T>, &count_block<T>};
+}
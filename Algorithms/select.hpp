@@ -0,0 +1,124 @@
+#ifndef SELECT
+#define SELECT
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <utility>
+#include "sort.hpp"
+
+/**
+ * Selection algorithms, for when only part of the sorted order is needed.
+ * custom::nth_element uses introselect: quickselect (quicksort that only follows the side holding the nth item) with a median of 3 pivot,
+ * switching to the median of medians pivot when the recursion gets too deep. Median of medians always splits off at least 30% of the items,
+ * so the worst case is O(n), while the average case keeps quickselect's speed.
+ * custom::top_k keeps a heap of the best k items seen so far, which takes O(n log k) time and only reads the input once
+*/
+namespace detail{
+    /**
+     * Partitions [first, last) around the pivot at *first, without relying on sentinels.
+     * Returns the pivot's final position. Everything before it is <= the pivot, and everything after it is >= the pivot.
+     * Items equal to the pivot stop both scans, so runs of equal items still split evenly
+    */
+    template<typename Iter>
+    constexpr Iter guarded_partition(Iter first, Iter last){
+        Iter lo = first + 1;
+        Iter hi = last - 1;
+        while(true){
+            while(lo <= hi && *lo < *first) ++lo;
+            while(lo <= hi && *first < *hi) --hi;
+            if(lo >= hi) break;
+            std::iter_swap(lo, hi);
+            ++lo;
+            --hi;
+        }
+        std::iter_swap(first, lo - 1); //Everything in [first + 1, lo) is <= the pivot, so the pivot goes at the end of that range
+        return lo - 1;
+    }
+
+    /**
+     * Median of medians selection. Sorts every group of 5 items, gathers the group medians at the front, and recursively finds their median to use as the pivot.
+     * O(n) in the worst case, but with a much bigger constant than quickselect, so it is only used as a fallback
+    */
+    template<typename Iter>
+    void median_of_medians_select(Iter first, Iter nth, Iter last){
+        while(last - first > 5){
+            Iter medians = first;
+            for(Iter group = first; last - group >= 5; group += 5){
+                detail::insertion_sort(group, group + 5);
+                std::iter_swap(medians, group + 2); //Gather the group's median at the front
+                ++medians;
+            }
+            Iter pivot = first + (medians - first) / 2;
+            detail::median_of_medians_select(first, pivot, medians);
+            std::iter_swap(first, pivot);
+
+            Iter cut = detail::guarded_partition(first, last);
+            if(cut == nth) return;
+            if(nth < cut) last = cut;
+            else first = cut + 1;
+        }
+        detail::insertion_sort(first, last);
+    }
+
+    /**
+     * The introselect loop
+     * Follows only the partition holding nth. After @param max_depth partitions it switches to median of medians
+    */
+    template<typename Iter>
+    void introselect(Iter first, Iter nth, Iter last, size_t max_depth){
+        while(last - first > 3){
+            if(max_depth == 0){ //The median of 3 pivots keep being bad, switch to a pivot that is guaranteed to be good
+                detail::median_of_medians_select(first, nth, last);
+                return;
+            }
+            --max_depth;
+            Iter cut = detail::get_pivot(first, last);
+            if(cut <= nth) first = cut;
+            else last = cut;
+        }
+        detail::insertion_sort(first, last);
+    }
+}
+
+/**
+ * Entry Points for user are custom::nth_element and custom::top_k
+*/
+namespace custom{
+    /**
+     * Moves the item that would be at nth in sorted order to nth.
+     * Everything before nth is <= it, and everything after nth is >= it
+    */
+    template<typename Iter>
+    void nth_element(Iter first, Iter nth, Iter last){
+        if(first == last || nth == last) return;
+        size_t max_depth = std::log2(last - first) * 2;
+        detail::introselect(first, nth, last, max_depth);
+    }
+
+    /**
+     * Copies the k largest items of [first, last) into d_first, largest first. The input is only read, once.
+     * A min-heap of the best k items seen so far is kept in the output, so each item that doesn't make the cut costs a single comparison.
+     * @param d_first must be random access and have room for k items. Returns the end of the output
+    */
+    template<typename InputIterator, class RandomAccessIterator>
+    RandomAccessIterator top_k(InputIterator first, InputIterator last, size_t k, RandomAccessIterator d_first){
+        typedef typename std::iterator_traits<RandomAccessIterator>::value_type ValueType;
+        auto greater = [](const ValueType& a, const ValueType& b){ return b < a; }; //Turns the max heap into a min heap, so the worst of the best k is on top
+        if(k == 0) return d_first;
+
+        RandomAccessIterator heap_end = d_first;
+        for(; first != last && size_t(heap_end - d_first) < k; ++first, ++heap_end){
+            *heap_end = *first;
+        }
+        detail::make_heap(d_first, heap_end, greater);
+        for(; first != last; ++first){
+            if(*d_first < *first){ //Better than the worst item kept so far. It replaces the top and sifts down
+                ValueType val = *first;
+                detail::adjust_heap(d_first, typename std::iterator_traits<RandomAccessIterator>::difference_type(0), heap_end - d_first, std::move(val), greater);
+            }
+        }
+        detail::sort_heap(d_first, heap_end, greater);
+        return heap_end;
+    }
+}
+#endif //SELECT
@@ -1,6 +1,19 @@
 #ifndef SORT
 #define SORT
 #include <cmath>
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include "sortingNetwork.hpp"
+#include "threadPool.hpp"
 
 /**
  * This is my implementation of introsort (introspective sort).
@@ -10,39 +23,22 @@
  * 
  * Introsort is an unstable sorting algorithm, but is an in-place sorting algorithm.
  * The Time Complexity for introsort is O(n log n), both best and worst case.
- *    To shorten the best-case time complexity, PDQ (pattern-defeating quicksort) is a viable alternative
+ *    To shorten the best-case time complexity, PDQ (pattern-defeating quicksort) is a viable alternative, and is available as custom::pdq_sort
  * 
  * The Space Complexity for introsort is O(log n), due to quicksort recursion
 */
 namespace detail{
 
     //Heapsort Section ------------------------------------------------------------------------
-    /**
-     * Removes the sorted item from the heap
-    */
-    template<typename Iter>
-    constexpr void pop_heap(Iter first, Iter result){
-        *result = std::move(*first);
-    }
-
-    /**
-     * Loops through the heap and removes each sorted item
-    */
-    template<typename Iter>
-    constexpr void sort_heap(Iter first, Iter last){
-        while(last - first > 1){
-            --last;
-            detail::pop_heap(first, last);
-        }
-    }
+    //The heap functions take a comparison so custom::top_k can build a min-heap. Everything else uses std::less<>, i.e. operator<
 
     /**
      * Moves nodes around to insert the current val into the correct place into the heap
     */
-    template<class Iter, class Distance, class Type>
-    constexpr void push_heap(Iter first, Distance index, Distance topIndex, Type val){
+    template<class Iter, class Distance, class Type, class Compare = std::less<>>
+    constexpr void push_heap(Iter first, Distance index, Distance topIndex, Type val, Compare comp = Compare()){
         Distance parent = (index - 1) / 2; //The current index's parent node
-        while(index > topIndex && *(first + parent) < val){ //While the current index is not at the top of the tree and the current index's parent is < val
+        while(index > topIndex && comp(*(first + parent), val)){ //While the current index is not at the top of the tree and the current index's parent is < val
             *(first + index) = std::move(*(first + parent)); //Move the current index's parent into the index
             index = parent; //The index is now the parent node
             parent = (index - 1) / 2; //New parent node for current index
@@ -51,31 +47,54 @@ namespace detail{
     }
 
     /**
-     * Organizes the heap into a binary tree
+     * Sifts val down from the node at index.
+     * The hole at index is moved down to a leaf by always following the larger child, then val is pushed back up from there.
+     * This needs about half the comparisons of checking val against both children at every level, since val usually belongs near the bottom
     */
-    template<class Iter, class Distance, class Type>
-    constexpr void adjust_heap(Iter first, Distance index, Distance length, Type val){
+    template<class Iter, class Distance, class Type, class Compare = std::less<>>
+    constexpr void adjust_heap(Iter first, Distance index, Distance length, Type val, Compare comp = Compare()){
         const Distance topIndex = index;
         Distance child = index;
-        while(child < (length - 1) / 2){ //While the child is not to its parent node
-            child = 2 * (child + 1); //Move to the next child node
-            if(*(first + child) < *(first + (child - 1))) --child; //Get the larger of the two child nodes
+        while(child < (length - 1) / 2){ //While the current node has two children
+            child = 2 * (child + 1); //Move to the right child node
+            if(comp(*(first + child), *(first + (child - 1)))) --child; //Get the larger of the two child nodes
             *(first + index) = std::move(*(first + child)); //Move the larger child node into the current index
             index = child;
         }
-        if((length & 1) == 0 && child == (length - 2) / 2){ //If unbalanced heap and the child is the right child node
-            child = 2 * (child + 1); //Move the child down and make it a left child
+        if((length & 1) == 0 && child == (length - 2) / 2){ //If the heap has an even length, the last parent node only has a left child
+            child = 2 * (child + 1);
             *(first + index) = std::move(*(first + (child - 1)));
             index = child - 1;
-            push_heap(first, index, topIndex, std::move(val));
         }
+        detail::push_heap(first, index, topIndex, std::move(val), comp); //The hole is now at a leaf, sift val back up to where it belongs
     }
 
     /**
-     * Creates an unorganized heap
+     * Moves the top of the heap [first, last) into result, and puts the item that was in result into the heap
     */
-    template<typename Iter>
-    constexpr void make_heap(Iter first, Iter last){
+    template<typename Iter, class Compare = std::less<>>
+    constexpr void pop_heap(Iter first, Iter last, Iter result, Compare comp = Compare()){
+        typename std::iterator_traits<Iter>::value_type val = std::move(*result);
+        *result = std::move(*first);
+        detail::adjust_heap(first, typename std::iterator_traits<Iter>::difference_type(0), last - first, std::move(val), comp);
+    }
+
+    /**
+     * Loops through the heap and removes each sorted item
+    */
+    template<typename Iter, class Compare = std::less<>>
+    constexpr void sort_heap(Iter first, Iter last, Compare comp = Compare()){
+        while(last - first > 1){
+            --last;
+            detail::pop_heap(first, last, last, comp); //The largest item goes to the back, and the heap shrinks by one
+        }
+    }
+
+    /**
+     * Builds a max heap out of [first, last)
+    */
+    template<typename Iter, class Compare = std::less<>>
+    constexpr void make_heap(Iter first, Iter last, Compare comp = Compare()){
         if(last - first < 2) return; //Arrays of size 0 and 1 are sorted
         typedef typename std::iterator_traits<Iter>::value_type ValueType;
         typedef typename std::iterator_traits<Iter>::difference_type DistanceType;
@@ -84,31 +103,31 @@ namespace detail{
         DistanceType parent = (length - 2) / 2;
         while(true){//While the parent is not first
             ValueType val = std::move(*(first + parent));
-            adjust_heap(first, parent, length, std::move(val)); //Move the parent to where it should be
+            detail::adjust_heap(first, parent, length, std::move(val), comp); //Move the parent to where it should be
             if(parent == 0) return;
             --parent;
         }
     }
 
     /**
-     * Make the heap. Then, for each node,
-     * starting with the midpoint -> end, if it is smaller than the first node remove it.
+     * Make a heap of the first (middle - first) items. Then, for each item from middle -> end,
+     * if it is smaller than the largest item in the heap, swap it in and push the largest item out
     */
-    template<typename Iter>
-    constexpr void heap_select(Iter first, Iter middle, Iter last){
-        detail::make_heap(first, middle);
+    template<typename Iter, class Compare = std::less<>>
+    constexpr void heap_select(Iter first, Iter middle, Iter last, Compare comp = Compare()){
+        detail::make_heap(first, middle, comp);
         for(Iter i = middle; i < last; ++i){
-            if(*i < *first) detail::pop_heap(first, i);
+            if(comp(*i, *first)) detail::pop_heap(first, middle, i, comp);
         }
     }
 
     /**
      * Start the heap process
     */
-    template<typename Iter>
-    constexpr void partial_sort(Iter first, Iter middle, Iter last){
-        heap_select(first, middle, last);
-        detail::sort_heap(first, middle);
+    template<typename Iter, class Compare = std::less<>>
+    constexpr void partial_sort(Iter first, Iter middle, Iter last, Compare comp = Compare()){
+        detail::heap_select(first, middle, last, comp);
+        detail::sort_heap(first, middle, comp);
     }
 
     //End Heapsort Section----------------------------------------------------------------------------
@@ -223,6 +242,388 @@ namespace detail{
     }
     //End Insertion Sort Section ---------------------------------------------------------------
 
+
+    //Radix Sort Section ------------------------------------------------------------------------
+    /**
+     * Keys that can be sorted by their bits: integers (other than bool) and IEEE 754 float/double
+    */
+    template<typename T>
+    concept radix_sortable = (std::is_integral_v<T> && !std::is_same_v<T, bool>)
+                          || (std::is_floating_point_v<T> && std::numeric_limits<T>::is_iec559 && (sizeof(T) == 4 || sizeof(T) == 8));
+
+    /**
+     * Below this many elements the histogram and scatter passes cost more than they save, so introsort is used instead
+    */
+    inline constexpr std::ptrdiff_t radix_sort_threshold = 1024;
+
+    template<size_t Bytes> struct radix_key;
+    template<> struct radix_key<1> { using type = std::uint8_t; };
+    template<> struct radix_key<2> { using type = std::uint16_t; };
+    template<> struct radix_key<4> { using type = std::uint32_t; };
+    template<> struct radix_key<8> { using type = std::uint64_t; };
+
+    /**
+     * Maps a value onto an unsigned key with the same ordering.
+     * Signed integers get their sign bit flipped so negatives come first.
+     * Floats get their sign bit flipped when positive and every bit flipped when negative, which orders them as
+     * -NaN < -inf < ... < -0.0 < +0.0 < ... < +inf < +NaN (the IEEE 754 totalOrder)
+    */
+    template<typename T>
+    constexpr auto to_radix_key(T value) noexcept {
+        using Key = typename radix_key<sizeof(T)>::type;
+        constexpr Key sign = Key(Key(1) << (sizeof(Key) * 8 - 1));
+        if constexpr (std::is_floating_point_v<T>){
+            const Key bits = std::bit_cast<Key>(value);
+            return (bits & sign) ? Key(~bits) : Key(bits | sign);
+        }
+        else if constexpr (std::is_signed_v<T>) return Key(Key(value) ^ sign);
+        else return Key(value);
+    }
+
+    /**
+     * LSD (least significant digit first) radix sort.
+     * 32 and 64 bit keys use 11 bit digits (3 and 6 passes), smaller keys use 8 bit digits.
+     * One pass builds the histogram for every digit, then each digit is scattered back and forth between the array and @param buffer.
+     * Digits where every key lands in the same bucket are skipped, so e.g. small IDs stored in 64 bit integers only pay for the low digits
+    */
+    template<typename T>
+    void radix_sort(T* first, T* last, T* buffer) {
+        constexpr size_t bits = sizeof(T) >= 4 ? 11 : 8;
+        constexpr size_t buckets = size_t(1) << bits;
+        constexpr size_t digits = (sizeof(T) * 8 + bits - 1) / bits;
+        const size_t length = size_t(last - first);
+        std::unique_ptr<size_t[]> counts(new size_t[digits * buckets]()); //Too big for the stack with 11 bit digits
+
+        for(T* it = first; it != last; ++it){ //Histogram every digit in a single pass
+            const auto key = to_radix_key(*it);
+            for(size_t d = 0; d < digits; ++d) ++counts[d * buckets + ((key >> (d * bits)) & (buckets - 1))];
+        }
+
+        T* from = first;
+        T* to = buffer;
+        for(size_t d = 0; d < digits; ++d){
+            size_t* count = counts.get() + d * buckets;
+            const size_t shift = d * bits;
+            if(count[(to_radix_key(*first) >> shift) & (buckets - 1)] == length) continue; //Every key shares this digit, nothing would move
+
+            size_t offset = 0;
+            for(size_t b = 0; b < buckets; ++b){ //Turn the counts into starting offsets
+                const size_t c = count[b];
+                count[b] = offset;
+                offset += c;
+            }
+            for(size_t i = 0; i < length; ++i){
+                const T value = from[i];
+                to[count[(to_radix_key(value) >> shift) & (buckets - 1)]++] = value;
+            }
+            std::swap(from, to);
+        }
+        if(from != first) std::memcpy(first, from, length * sizeof(T)); //An odd number of passes leaves the result in the buffer
+    }
+    //End Radix Sort Section --------------------------------------------------------------------
+
+    //Pattern-Defeating Quicksort Section ------------------------------------------------------------
+    inline constexpr std::ptrdiff_t pdq_insertion_sort_threshold = 24; //Partitions smaller than this are insertion sorted
+    inline constexpr std::ptrdiff_t pdq_ninther_threshold = 128; //Partitions bigger than this use Tukey's ninther for the pivot
+    inline constexpr size_t pdq_partial_insertion_sort_limit = 8; //How many elements partial_insertion_sort may move before giving up
+    inline constexpr size_t pdq_block_size = 64; //Elements classified per block by the branchless partition. Offsets must fit in an unsigned char
+
+    /**
+     * Sorts 2 or 3 items in place. Used to pick the pivot candidates
+    */
+    template<typename Iter>
+    constexpr void sort2(Iter a, Iter b){
+        if(*b < *a) std::iter_swap(a, b);
+    }
+
+    template<typename Iter>
+    constexpr void sort3(Iter a, Iter b, Iter c){
+        detail::sort2(a, b);
+        detail::sort2(b, c);
+        detail::sort2(a, b);
+    }
+
+    /**
+     * Checks whether the whole range is already in order.
+     * A non-increasing range is reversed in place, so both sorted and reverse-sorted inputs finish in O(n).
+     * The scan stops at the first item that breaks both orders, so unsorted inputs only pay for a few comparisons
+    */
+    template<typename Iter>
+    constexpr bool sorted_or_reversed(Iter first, Iter last){
+        Iter i = first + 1;
+        if(*i < *first){
+            while(++i != last && !(*(i - 1) < *i)); //Look for the end of the non-increasing run
+            if(i != last) return false;
+            std::reverse(first, last);
+            return true;
+        }
+        while(++i != last && !(*i < *(i - 1))); //Look for the end of the non-decreasing run
+        return i == last;
+    }
+
+    /**
+     * Insertion sort that gives up once more than pdq_partial_insertion_sort_limit items have been moved.
+     * Returns true if the range ended up sorted. Used to finish partitions that look already sorted in linear time
+    */
+    template<typename Iter>
+    constexpr bool partial_insertion_sort(Iter first, Iter last){
+        if(first == last) return true;
+        size_t moved = 0;
+        for(Iter i = first + 1; i != last; ++i){
+            Iter sift = i;
+            Iter prev = i - 1;
+            if(*sift < *prev){
+                typename std::iterator_traits<Iter>::value_type val = std::move(*sift);
+                do{
+                    *sift-- = std::move(*prev);
+                } while(sift != first && val < *--prev);
+                *sift = std::move(val);
+                moved += i - sift;
+                if(moved > pdq_partial_insertion_sort_limit) return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * Partitions [first, last) around the pivot at *first. Items equal to the pivot go to the right.
+     * Returns the pivot's final position, and whether the range was already partitioned (no swaps were needed)
+    */
+    template<typename Iter>
+    constexpr std::pair<Iter, bool> partition_right(Iter begin, Iter end){
+        typename std::iterator_traits<Iter>::value_type pivot = std::move(*begin);
+        Iter first = begin;
+        Iter last = end;
+
+        while(*++first < pivot); //The median of 3 guarantees an item >= pivot exists, so this is safe
+        if(first - 1 == begin) while(first < last && !(*--last < pivot)); //Nothing before first was moved, so the right scan needs a bound
+        else while(!(*--last < pivot));
+
+        const bool already_partitioned = first >= last;
+        while(first < last){
+            std::iter_swap(first, last);
+            while(*++first < pivot);
+            while(!(*--last < pivot));
+        }
+
+        Iter pivot_pos = first - 1;
+        *begin = std::move(*pivot_pos);
+        *pivot_pos = std::move(pivot);
+        return {pivot_pos, already_partitioned};
+    }
+
+    /**
+     * Moves the items at the given offsets from the left and right blocks across to the other side.
+     * When both blocks have the same number of misplaced items, plain swaps are used. Otherwise the items are rotated
+     * through a single temporary, which needs fewer moves
+    */
+    template<typename Iter>
+    constexpr void swap_offsets(Iter first, Iter last, unsigned char* offsets_l, unsigned char* offsets_r, size_t num, bool use_swaps){
+        if(use_swaps){
+            for(size_t i = 0; i < num; ++i) std::iter_swap(first + offsets_l[i], last - offsets_r[i]);
+        }
+        else if(num > 0){
+            Iter l = first + offsets_l[0];
+            Iter r = last - offsets_r[0];
+            typename std::iterator_traits<Iter>::value_type tmp = std::move(*l);
+            *l = std::move(*r);
+            for(size_t i = 1; i < num; ++i){
+                l = first + offsets_l[i];
+                *r = std::move(*l);
+                r = last - offsets_r[i];
+                *l = std::move(*r);
+            }
+            *r = std::move(tmp);
+        }
+    }
+
+    /**
+     * Branchless version of partition_right, based on BlockQuicksort (Edelkamp & Weiss).
+     * Instead of swapping as soon as a misplaced item is found, a block of items from each side is classified first, storing the offsets
+     * of the misplaced ones. The comparison result is added to the offset count rather than branched on, so the loop has no
+     * data-dependent branches to mispredict. The misplaced items are then swapped pairwise.
+     * Only used for arithmetic types, where comparisons are cheap enough for the branch to be the bottleneck
+    */
+    template<typename Iter>
+    std::pair<Iter, bool> partition_right_branchless(Iter begin, Iter end){
+        typename std::iterator_traits<Iter>::value_type pivot = std::move(*begin);
+        Iter first = begin;
+        Iter last = end;
+
+        while(*++first < pivot);
+        if(first - 1 == begin) while(first < last && !(*--last < pivot));
+        else while(!(*--last < pivot));
+
+        const bool already_partitioned = first >= last;
+        if(!already_partitioned){
+            std::iter_swap(first, last);
+            ++first; //[first, last) is now the unclassified range
+
+            alignas(64) unsigned char offsets_l[pdq_block_size];
+            alignas(64) unsigned char offsets_r[pdq_block_size];
+            Iter offsets_l_base = first;
+            Iter offsets_r_base = last;
+            size_t num_l = 0, num_r = 0, start_l = 0, start_r = 0;
+
+            while(first < last){
+                //Only refill a block once it has been emptied. If both are empty, split the unclassified items between them
+                const size_t num_unknown = last - first;
+                const size_t left_split = num_l == 0 ? (num_r == 0 ? num_unknown / 2 : num_unknown) : 0;
+                const size_t right_split = num_r == 0 ? (num_unknown - left_split) : 0;
+
+                const size_t left_count = left_split < pdq_block_size ? left_split : pdq_block_size;
+                for(size_t i = 0; i < left_count; ++i){
+                    offsets_l[num_l] = static_cast<unsigned char>(i);
+                    num_l += !(*first < pivot); //Items >= pivot are misplaced on the left
+                    ++first;
+                }
+                const size_t right_count = right_split < pdq_block_size ? right_split : pdq_block_size;
+                for(size_t i = 0; i < right_count; ++i){
+                    offsets_r[num_r] = static_cast<unsigned char>(i + 1);
+                    num_r += *--last < pivot; //Items < pivot are misplaced on the right
+                }
+
+                const size_t num = num_l < num_r ? num_l : num_r;
+                detail::swap_offsets(offsets_l_base, offsets_r_base, offsets_l + start_l, offsets_r + start_r, num, num_l == num_r);
+                num_l -= num;
+                num_r -= num;
+                start_l += num;
+                start_r += num;
+                if(num_l == 0){
+                    start_l = 0;
+                    offsets_l_base = first;
+                }
+                if(num_r == 0){
+                    start_r = 0;
+                    offsets_r_base = last;
+                }
+            }
+
+            //At most one block still has misplaced items. Move them to the boundary
+            if(num_l){
+                while(num_l--) std::iter_swap(offsets_l_base + offsets_l[start_l + num_l], --last);
+                first = last;
+            }
+            if(num_r){
+                while(num_r--){
+                    std::iter_swap(offsets_r_base - offsets_r[start_r + num_r], first);
+                    ++first;
+                }
+            }
+        }
+
+        Iter pivot_pos = first - 1;
+        *begin = std::move(*pivot_pos);
+        *pivot_pos = std::move(pivot);
+        return {pivot_pos, already_partitioned};
+    }
+
+    /**
+     * Partitions [first, last) around the pivot at *first, putting items equal to the pivot on the left.
+     * Only called when the pivot equals the item just before the range, which means every item equal to the pivot is already
+     * in its final place once it is on the left. This makes inputs with few distinct values take linear time per distinct value
+    */
+    template<typename Iter>
+    constexpr Iter partition_left(Iter begin, Iter end){
+        typename std::iterator_traits<Iter>::value_type pivot = std::move(*begin);
+        Iter first = begin;
+        Iter last = end;
+
+        while(pivot < *--last);
+        if(last + 1 == end) while(first < last && !(pivot < *++first));
+        else while(!(pivot < *++first));
+
+        while(first < last){
+            std::iter_swap(first, last);
+            while(pivot < *--last);
+            while(!(pivot < *++first));
+        }
+
+        Iter pivot_pos = last;
+        *begin = std::move(*pivot_pos);
+        *pivot_pos = std::move(pivot);
+        return pivot_pos;
+    }
+
+    /**
+     * The pdqsort loop
+     * @param bad_allowed is how many highly unbalanced partitions are tolerated before switching to heapsort.
+     * @param leftmost is true when there is no item before first. Otherwise *(first - 1) is <= every item in the range,
+     * which lets insertion sort run unguarded and lets runs of equal items be detected.
+    */
+    template<bool Branchless, typename Iter>
+    void pdqsort_loop(Iter first, Iter last, int bad_allowed, bool leftmost = true) {
+        while(true){
+            const std::ptrdiff_t size = last - first;
+            if(size < pdq_insertion_sort_threshold){
+                if(leftmost) detail::insertion_sort(first, last);
+                else detail::unguarded_insertion_sort(first, last);
+                return;
+            }
+
+            //Pick the pivot as the median of 3, or Tukey's ninther for big partitions, and move it to the front
+            const std::ptrdiff_t half = size / 2;
+            if(size > pdq_ninther_threshold){
+                detail::sort3(first, first + half, last - 1);
+                detail::sort3(first + 1, first + (half - 1), last - 2);
+                detail::sort3(first + 2, first + (half + 1), last - 3);
+                detail::sort3(first + (half - 1), first + half, first + (half + 1));
+                std::iter_swap(first, first + half);
+            }
+            else detail::sort3(first + half, first, last - 1);
+
+            //If the pivot equals the item before this partition, every item equal to the pivot is done. Skip past them
+            if(!leftmost && !(*(first - 1) < *first)){
+                first = detail::partition_left(first, last) + 1;
+                continue;
+            }
+
+            std::pair<Iter, bool> result;
+            if constexpr (Branchless) result = detail::partition_right_branchless(first, last);
+            else result = detail::partition_right(first, last);
+            const Iter pivot_pos = result.first;
+            const bool already_partitioned = result.second;
+
+            const std::ptrdiff_t l_size = pivot_pos - first;
+            const std::ptrdiff_t r_size = last - (pivot_pos + 1);
+            if(l_size < size / 8 || r_size < size / 8){ //A highly unbalanced partition means the input has a pattern that beats the pivot choice
+                if(--bad_allowed == 0){ //Too many bad partitions in a row, guarantee O(n log n) with heapsort
+                    detail::partial_sort(first, last, last);
+                    return;
+                }
+                //Swap a few items around to break up the pattern before the next pivot is chosen
+                if(l_size >= pdq_insertion_sort_threshold){
+                    std::iter_swap(first, first + l_size / 4);
+                    std::iter_swap(pivot_pos - 1, pivot_pos - l_size / 4);
+                    if(l_size > pdq_ninther_threshold){
+                        std::iter_swap(first + 1, first + (l_size / 4 + 1));
+                        std::iter_swap(first + 2, first + (l_size / 4 + 2));
+                        std::iter_swap(pivot_pos - 2, pivot_pos - (l_size / 4 + 1));
+                        std::iter_swap(pivot_pos - 3, pivot_pos - (l_size / 4 + 2));
+                    }
+                }
+                if(r_size >= pdq_insertion_sort_threshold){
+                    std::iter_swap(pivot_pos + 1, pivot_pos + (1 + r_size / 4));
+                    std::iter_swap(last - 1, last - r_size / 4);
+                    if(r_size > pdq_ninther_threshold){
+                        std::iter_swap(pivot_pos + 2, pivot_pos + (2 + r_size / 4));
+                        std::iter_swap(pivot_pos + 3, pivot_pos + (3 + r_size / 4));
+                        std::iter_swap(last - 2, last - (1 + r_size / 4));
+                        std::iter_swap(last - 3, last - (2 + r_size / 4));
+                    }
+                }
+            }
+            else if(already_partitioned //A balanced partition that needed no swaps is a hint that the input is sorted. Try to finish both sides in linear time
+                    && detail::partial_insertion_sort(first, pivot_pos)
+                    && detail::partial_insertion_sort(pivot_pos + 1, last)) return;
+
+            detail::pdqsort_loop<Branchless>(first, pivot_pos, bad_allowed, leftmost);
+            first = pivot_pos + 1; //Everything left of the pivot is <= every item on the right
+            leftmost = false;
+        }
+    }
+    //End Pattern-Defeating Quicksort Section --------------------------------------------------------
+
     /**
     * The introsort loop
     * Recursively calls itself until a specified max-depth is hit.
@@ -240,6 +641,63 @@ namespace detail{
             last = p; //Splitting the array into [first, p) and [p, last), where p is the quicksort pivot
         }
     }
+
+    /**
+     * Introsort for types with a sorting network kernel (see sortingNetwork.hpp).
+     * Quicksort stops once a partition fits in one network block, and each leaf is sorted on its own instead of by a final insertion sort pass.
+     * Leaves too small to be worth padding out to a whole block still use insertion sort
+    */
+    template<typename T>
+    void network_introsort(T* first, T* last, size_t max_depth, const network_kernel<T>& kernel) {
+        while (last - first > kernel.block) {
+            if (max_depth == 0) {
+                detail::partial_sort(first, last, last);
+                return;
+            }
+            --max_depth;
+            T* p = detail::get_pivot(first, last);
+            network_introsort(p, last, max_depth, kernel);
+            last = p;
+        }
+        if (last - first <= std::max<std::ptrdiff_t>(kernel.block / 2, 16) || !kernel.sort(first, last)) detail::insertion_sort(first, last);
+    }
+
+    /**
+     * Sorts [first, last) completely with introsort, using the sorting network kernel for the leaves when the type and the CPU have one
+    */
+    template<typename Iter>
+    void introsort_full(Iter first, Iter last, size_t max_depth) {
+        typedef typename std::iterator_traits<Iter>::value_type ValueType;
+        if constexpr (network_sortable<ValueType> && std::contiguous_iterator<Iter>){
+            if(const network_kernel<ValueType>* kernel = detail::network_kernel_for<ValueType>()){
+                detail::network_introsort(std::to_address(first), std::to_address(last), max_depth, *kernel);
+                return;
+            }
+        }
+        detail::introsort(first, last, max_depth);
+        detail::final_insertion_sort(first, last);
+    }
+
+    /**
+     * The parallel introsort loop
+     * Works like introsort, but instead of recursing into the right-hand partition it is handed to the task group,
+     * where any idle worker can steal it. Once a partition is no bigger than @param grain it is finished serially, including its final insertion sort.
+     * Every partition sits entirely before its right-hand neighbour, so the partitions can be sorted independently
+    */
+    template<typename Iter>
+    void parallel_introsort(custom::taskGroup& group, Iter first, Iter last, size_t max_depth, std::ptrdiff_t grain) {
+        while (last - first > grain) {
+            if (max_depth == 0) {
+                detail::partial_sort(first, last, last);
+                return;
+            }
+            --max_depth;
+            Iter p = detail::get_pivot(first, last);
+            group.run([&group, p, last, max_depth, grain]{ detail::parallel_introsort(group, p, last, max_depth, grain); });
+            last = p;
+        }
+        detail::introsort_full(first, last, max_depth);
+    }
 }
 
 /**
@@ -249,9 +707,61 @@ namespace custom{
     template<typename Iter>
     void sort(Iter first, Iter last){
         if(first >= last) return; //Empty array
+        typedef typename std::iterator_traits<Iter>::value_type ValueType;
+        if constexpr (detail::radix_sortable<ValueType> && std::contiguous_iterator<Iter>){ //Arithmetic keys in contiguous memory can be radix sorted in O(n)
+            if(last - first >= detail::radix_sort_threshold){
+                std::unique_ptr<ValueType[]> buffer(new (std::nothrow) ValueType[last - first]);
+                if(buffer){ //Without the scratch buffer, fall through to the in-place introsort
+                    detail::radix_sort(std::to_address(first), std::to_address(last), buffer.get());
+                    return;
+                }
+            }
+        }
         size_t max_depth = std::log2(last - first) * 2; //Gets the max recursion depth based on the array's size
-        detail::introsort(first, last, max_depth); //Start the bulk sorting
-        detail::final_insertion_sort(first, last); //Do a quick run through to finish sorting the array
+        detail::introsort_full(first, last, max_depth); //Quicksort down to small partitions, then finish them with insertion sort or a sorting network
+    }
+
+    /**
+     * Sorts the smallest (middle - first) items into [first, middle). The order of the items left in [middle, last) is unspecified.
+     * Uses a heap of the first (middle - first) items, so it takes O(n log k) time for k = middle - first
+    */
+    template<typename Iter>
+    void partial_sort(Iter first, Iter middle, Iter last){
+        if(first == middle) return;
+        detail::partial_sort(first, middle, last);
+    }
+
+    /**
+     * Pattern-defeating quicksort (pdqsort).
+     * Like introsort, but adapts to patterns in the input: sorted and reverse-sorted inputs take O(n),
+     * inputs with few distinct values take O(n k) for k distinct values, and adversarial inputs are shuffled rather than sent straight to heapsort.
+     * Arithmetic types use a branchless block partition
+    */
+    template<typename Iter>
+    void pdq_sort(Iter first, Iter last){
+        if(last - first < 2) return;
+        if(detail::sorted_or_reversed(first, last)) return;
+        typedef typename std::iterator_traits<Iter>::value_type ValueType;
+        detail::pdqsort_loop<std::is_arithmetic_v<ValueType> || std::is_pointer_v<ValueType>>(first, last, int(std::log2(last - first)));
+    }
+
+    /**
+     * Parallel introsort. Use custom::execution::par for the shared pool, or custom::execution::par.on(pool) to pick the pool (and therefore the worker count).
+     * Falls back to the serial sort when the range is no bigger than the policy's grain or the pool only has one worker
+    */
+    template<typename Iter>
+    void sort(const execution::parallel_policy& policy, Iter first, Iter last){
+        if(first >= last) return;
+        const std::ptrdiff_t grain = static_cast<std::ptrdiff_t>(policy.grain < 16 ? 16 : policy.grain); //Leaves must stay big enough for final_insertion_sort's unguarded pass
+        threadPool& pool = policy.get_pool();
+        if(last - first <= grain || pool.size() < 2){
+            custom::sort(first, last);
+            return;
+        }
+        size_t max_depth = std::log2(last - first) * 2;
+        taskGroup group(pool);
+        detail::parallel_introsort(group, first, last, max_depth, grain);
+        group.wait();
     }
 }
 #endif //SORT
\ No newline at end of file
@@ -0,0 +1,243 @@
+#ifndef SORTINGNETWORK
+#define SORTINGNETWORK
+#include <cstddef>
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define CUSTOM_SORTING_NETWORK_X86 1
+#include <immintrin.h>
+#endif
+
+/**
+ * SIMD sorting networks, used by the sorts in sort.hpp to finish small partitions of 32 and 64 bit integers and floats.
+ * A sorting network is a fixed sequence of compare-exchange steps (a = min(a, b), b = max(a, b)) that sorts any input.
+ * The steps don't depend on the data, so there are no branches to mispredict, and one SIMD min/max pair performs a whole row of steps at once.
+ *
+ * The block is held in 8 registers of k lanes each (8 x 8 for 32 bit types with AVX2, down to 8 x 2 for 64 bit types with SSE), and sorted with a
+ * bitonic network. Steps between items in different registers are plain vector min/max. Steps between lanes of the same register are done
+ * after transposing each k x k tile of registers, which turns lanes into registers. Smaller partitions are padded with the largest value.
+ * Floats are sorted as integers with the same order (see network_key), since float min/max can't tell -0.0 from +0.0 and would copy one zero over the other.
+ *
+ * The instruction set is picked at runtime: AVX2 if the CPU has it, otherwise SSE4.2, otherwise no kernel is returned and the scalar
+ * insertion sort is used. Only x86 with GCC or Clang gets kernels
+*/
+namespace detail{
+    /**
+     * Types the kernels can sort: signed 32/64 bit integers, and IEEE float/double
+    */
+    template<typename T>
+    concept network_sortable = (std::is_integral_v<T> && std::is_signed_v<T> && (sizeof(T) == 4 || sizeof(T) == 8))
+                            || (std::is_floating_point_v<T> && std::numeric_limits<T>::is_iec559 && (sizeof(T) == 4 || sizeof(T) == 8));
+
+    inline constexpr size_t network_registers = 8; //Registers per block. Must be >= the lane count, so the transposed tiles are square
+
+    /**
+     * A sorting network kernel for the current CPU.
+     * sort() sorts up to block items. It returns false without touching the range if it can't sort it (floats containing NaN, which have no place in
+     * operator<'s order), in which case the caller should use insertion sort instead
+    */
+    template<typename T>
+    struct network_kernel{
+        std::ptrdiff_t block;
+        bool (*sort)(T* first, T* last);
+    };
+
+    template<typename T>
+    using network_key_t = std::conditional_t<sizeof(T) == 4, int32_t, int64_t>; //The signed integer the network actually sorts T as
+
+    /**
+     * Maps @param value to a signed integer with the same order. Integers are their own keys. Floats keep their bits when positive and have every bit
+     * but the sign flipped when negative, which orders -inf < ... < -0.0 < +0.0 < ... < +inf, and keeps the two zeros apart
+    */
+    template<typename T>
+    constexpr network_key_t<T> network_key(T value) noexcept {
+        if constexpr (std::is_floating_point_v<T>){
+            using K = network_key_t<T>;
+            const K bits = std::bit_cast<K>(value);
+            return bits ^ ((bits >> (sizeof(K) * 8 - 1)) & std::numeric_limits<K>::max());
+        }
+        else return value;
+    }
+
+    /**
+     * Undoes network_key. The mapping leaves the sign bit alone, so it is its own inverse
+    */
+    template<typename T>
+    constexpr T network_value(network_key_t<T> key) noexcept {
+        if constexpr (std::is_floating_point_v<T>){
+            using K = network_key_t<T>;
+            return std::bit_cast<T>(K(key ^ ((key >> (sizeof(K) * 8 - 1)) & std::numeric_limits<K>::max())));
+        }
+        else return key;
+    }
+
+#ifdef CUSTOM_SORTING_NETWORK_X86
+    //Each instruction set gets a lanes<Bytes> traits class for signed integers, with load, store, min, max, reverse (the lane order) and transpose (a square tile of registers).
+    //Every function touching vector registers carries the target attribute, so the rest of the program can still be compiled for the baseline CPU
+    namespace avx2{
+#define CUSTOM_AVX2 __attribute__((target("avx2"), always_inline)) static inline
+
+        template<size_t Bytes> struct lanes;
+
+        struct transpose_avx2{
+            /**
+             * 8 x 8 transpose of 32 bit lanes
+            */
+            CUSTOM_AVX2 void transpose8(__m256* r){
+                const __m256 t0 = _mm256_unpacklo_ps(r[0], r[1]), t1 = _mm256_unpackhi_ps(r[0], r[1]);
+                const __m256 t2 = _mm256_unpacklo_ps(r[2], r[3]), t3 = _mm256_unpackhi_ps(r[2], r[3]);
+                const __m256 t4 = _mm256_unpacklo_ps(r[4], r[5]), t5 = _mm256_unpackhi_ps(r[4], r[5]);
+                const __m256 t6 = _mm256_unpacklo_ps(r[6], r[7]), t7 = _mm256_unpackhi_ps(r[6], r[7]);
+                const __m256 s0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0)), s1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+                const __m256 s2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0)), s3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+                const __m256 s4 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(1, 0, 1, 0)), s5 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(3, 2, 3, 2));
+                const __m256 s6 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(1, 0, 1, 0)), s7 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(3, 2, 3, 2));
+                r[0] = _mm256_permute2f128_ps(s0, s4, 0x20);
+                r[1] = _mm256_permute2f128_ps(s1, s5, 0x20);
+                r[2] = _mm256_permute2f128_ps(s2, s6, 0x20);
+                r[3] = _mm256_permute2f128_ps(s3, s7, 0x20);
+                r[4] = _mm256_permute2f128_ps(s0, s4, 0x31);
+                r[5] = _mm256_permute2f128_ps(s1, s5, 0x31);
+                r[6] = _mm256_permute2f128_ps(s2, s6, 0x31);
+                r[7] = _mm256_permute2f128_ps(s3, s7, 0x31);
+            }
+
+            /**
+             * 4 x 4 transpose of 64 bit lanes
+            */
+            CUSTOM_AVX2 void transpose4(__m256d* r){
+                const __m256d t0 = _mm256_unpacklo_pd(r[0], r[1]), t1 = _mm256_unpackhi_pd(r[0], r[1]);
+                const __m256d t2 = _mm256_unpacklo_pd(r[2], r[3]), t3 = _mm256_unpackhi_pd(r[2], r[3]);
+                r[0] = _mm256_permute2f128_pd(t0, t2, 0x20);
+                r[1] = _mm256_permute2f128_pd(t1, t3, 0x20);
+                r[2] = _mm256_permute2f128_pd(t0, t2, 0x31);
+                r[3] = _mm256_permute2f128_pd(t1, t3, 0x31);
+            }
+        };
+
+        template<> struct lanes<4>{
+            using reg = __m256i;
+            static constexpr size_t count = 8;
+            CUSTOM_AVX2 reg load(const void* p){ return _mm256_loadu_si256(static_cast<const __m256i*>(p)); }
+            CUSTOM_AVX2 void store(void* p, reg v){ _mm256_storeu_si256(static_cast<__m256i*>(p), v); }
+            CUSTOM_AVX2 reg min(reg a, reg b){ return _mm256_min_epi32(a, b); }
+            CUSTOM_AVX2 reg max(reg a, reg b){ return _mm256_max_epi32(a, b); }
+            CUSTOM_AVX2 reg reverse(reg v){ return _mm256_permutevar8x32_epi32(v, _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0)); }
+            CUSTOM_AVX2 void transpose(reg* r){
+                __m256 f[8];
+                for(size_t i = 0; i < 8; ++i) f[i] = _mm256_castsi256_ps(r[i]);
+                transpose_avx2::transpose8(f);
+                for(size_t i = 0; i < 8; ++i) r[i] = _mm256_castps_si256(f[i]);
+            }
+        };
+
+
+        template<> struct lanes<8>{
+            using reg = __m256i;
+            static constexpr size_t count = 4;
+            CUSTOM_AVX2 reg load(const void* p){ return _mm256_loadu_si256(static_cast<const __m256i*>(p)); }
+            CUSTOM_AVX2 void store(void* p, reg v){ _mm256_storeu_si256(static_cast<__m256i*>(p), v); }
+            CUSTOM_AVX2 reg min(reg a, reg b){ return _mm256_blendv_epi8(a, b, _mm256_cmpgt_epi64(a, b)); } //AVX2 has no 64 bit min/max, so compare and blend
+            CUSTOM_AVX2 reg max(reg a, reg b){ return _mm256_blendv_epi8(b, a, _mm256_cmpgt_epi64(a, b)); }
+            CUSTOM_AVX2 reg reverse(reg v){ return _mm256_permute4x64_epi64(v, _MM_SHUFFLE(0, 1, 2, 3)); }
+            CUSTOM_AVX2 void transpose(reg* r){
+                __m256d d[4];
+                for(size_t i = 0; i < 4; ++i) d[i] = _mm256_castsi256_pd(r[i]);
+                transpose_avx2::transpose4(d);
+                for(size_t i = 0; i < 4; ++i) r[i] = _mm256_castpd_si256(d[i]);
+            }
+        };
+
+#undef CUSTOM_AVX2
+    }
+
+    namespace sse42{
+#define CUSTOM_SSE42 __attribute__((target("sse4.2"), always_inline)) static inline
+
+        template<size_t Bytes> struct lanes;
+
+        struct transpose_sse{
+            /**
+             * 4 x 4 transpose of 32 bit lanes
+            */
+            CUSTOM_SSE42 void transpose4(__m128* r){
+                const __m128 t0 = _mm_unpacklo_ps(r[0], r[1]), t1 = _mm_unpackhi_ps(r[0], r[1]);
+                const __m128 t2 = _mm_unpacklo_ps(r[2], r[3]), t3 = _mm_unpackhi_ps(r[2], r[3]);
+                r[0] = _mm_movelh_ps(t0, t2);
+                r[1] = _mm_movehl_ps(t2, t0);
+                r[2] = _mm_movelh_ps(t1, t3);
+                r[3] = _mm_movehl_ps(t3, t1);
+            }
+        };
+
+        template<> struct lanes<4>{
+            using reg = __m128i;
+            static constexpr size_t count = 4;
+            CUSTOM_SSE42 reg load(const void* p){ return _mm_loadu_si128(static_cast<const __m128i*>(p)); }
+            CUSTOM_SSE42 void store(void* p, reg v){ _mm_storeu_si128(static_cast<__m128i*>(p), v); }
+            CUSTOM_SSE42 reg min(reg a, reg b){ return _mm_min_epi32(a, b); }
+            CUSTOM_SSE42 reg max(reg a, reg b){ return _mm_max_epi32(a, b); }
+            CUSTOM_SSE42 reg reverse(reg v){ return _mm_shuffle_epi32(v, _MM_SHUFFLE(0, 1, 2, 3)); }
+            CUSTOM_SSE42 void transpose(reg* r){
+                __m128 f[4];
+                for(size_t i = 0; i < 4; ++i) f[i] = _mm_castsi128_ps(r[i]);
+                transpose_sse::transpose4(f);
+                for(size_t i = 0; i < 4; ++i) r[i] = _mm_castps_si128(f[i]);
+            }
+        };
+
+
+        template<> struct lanes<8>{
+            using reg = __m128i;
+            static constexpr size_t count = 2;
+            CUSTOM_SSE42 reg load(const void* p){ return _mm_loadu_si128(static_cast<const __m128i*>(p)); }
+            CUSTOM_SSE42 void store(void* p, reg v){ _mm_storeu_si128(static_cast<__m128i*>(p), v); }
+            CUSTOM_SSE42 reg min(reg a, reg b){ return _mm_blendv_epi8(a, b, _mm_cmpgt_epi64(a, b)); } //64 bit compare is the SSE4.2 part
+            CUSTOM_SSE42 reg max(reg a, reg b){ return _mm_blendv_epi8(b, a, _mm_cmpgt_epi64(a, b)); }
+            CUSTOM_SSE42 reg reverse(reg v){ return _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)); }
+            CUSTOM_SSE42 void transpose(reg* r){
+                const reg lo = _mm_unpacklo_epi64(r[0], r[1]);
+                r[1] = _mm_unpackhi_epi64(r[0], r[1]);
+                r[0] = lo;
+            }
+        };
+
+#undef CUSTOM_SSE42
+    }
+
+    //The network itself is the same for every instruction set, but has to be compiled once per target
+#define CUSTOM_NETWORK_NAMESPACE avx2
+#define CUSTOM_NETWORK_TARGET "avx2"
+#include "sortingNetworkKernel.hpp"
+#undef CUSTOM_NETWORK_NAMESPACE
+#undef CUSTOM_NETWORK_TARGET
+
+#define CUSTOM_NETWORK_NAMESPACE sse42
+#define CUSTOM_NETWORK_TARGET "sse4.2"
+#include "sortingNetworkKernel.hpp"
+#undef CUSTOM_NETWORK_NAMESPACE
+#undef CUSTOM_NETWORK_TARGET
+#endif //CUSTOM_SORTING_NETWORK_X86
+
+    /**
+     * Returns the best kernel the CPU supports for T, or nullptr if there is none. The CPU is only checked once per type
+    */
+    template<typename T>
+    const network_kernel<T>* network_kernel_for() noexcept {
+#ifdef CUSTOM_SORTING_NETWORK_X86
+        static const network_kernel<T>* const kernel = []() -> const network_kernel<T>* {
+            __builtin_cpu_init();
+            if(__builtin_cpu_supports("avx2")) return &avx2::kernel<T>;
+            if(__builtin_cpu_supports("sse4.2")) return &sse42::kernel<T>;
+            return nullptr;
+        }();
+        return kernel;
+#else
+        return nullptr;
+#endif
+    }
+}
+#endif //SORTINGNETWORK
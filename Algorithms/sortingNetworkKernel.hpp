@@ -0,0 +1,102 @@
+//No include guard: sortingNetwork.hpp includes this file once per instruction set,
+//with CUSTOM_NETWORK_NAMESPACE naming the namespace holding that set's lanes traits and CUSTOM_NETWORK_TARGET naming the target
+
+/**
+ * The bitonic sorting network, written against the lanes traits of one instruction set.
+ * Item i of the block lives in register i / k, lane i % k (the row layout). In the transposed layout every k x k tile of registers is transposed,
+ * so a compare-exchange between lanes c and c ^ j of one register becomes one between registers c and c ^ j of its tile.
+ *
+ * This version of the bitonic sort only ever puts the smaller item first: merging two sorted halves of size s starts by comparing each item with its mirror
+ * in the other half (the flip), then with the item s/2, s/4, ..., 1 places away (the half-cleaners).
+ * Keeping every step ascending is what lets a whole register be handled with a single min and max
+*/
+namespace CUSTOM_NETWORK_NAMESPACE{
+    template<class V>
+    __attribute__((target(CUSTOM_NETWORK_TARGET), always_inline)) inline void compare_exchange(typename V::reg& a, typename V::reg& b){
+        const typename V::reg lo = V::min(a, b);
+        b = V::max(a, b);
+        a = lo;
+    }
+
+    /**
+     * Switches between the row layout and the transposed layout. Transposing is its own inverse
+    */
+    template<class V>
+    __attribute__((target(CUSTOM_NETWORK_TARGET), always_inline)) inline void set_layout(typename V::reg* regs, bool& transposed, bool want){
+        if(transposed == want) return;
+        for(size_t tile = 0; tile < network_registers; tile += V::count) V::transpose(regs + tile);
+        transposed = want;
+    }
+
+    /**
+     * Sorts the items held in regs, ending in the row layout
+    */
+    template<class V>
+    __attribute__((target(CUSTOM_NETWORK_TARGET))) inline void bitonic_network(typename V::reg* regs){
+        constexpr size_t k = V::count;
+        constexpr size_t items = network_registers * k;
+        bool transposed = false;
+        for(size_t s = 1; s < items; s *= 2){ //Merge sorted runs of s items into runs of 2s
+            if(2 * s <= k){ //The flip stays inside each register's lanes, so do it on the transposed tiles
+                set_layout<V>(regs, transposed, true);
+                for(size_t q = 0; q < network_registers; ++q){
+                    if(!(q & s)) compare_exchange<V>(regs[q], regs[q ^ (2 * s - 1)]);
+                }
+            }
+            else{ //The flip mirrors every lane and a group of registers. Reverse the upper register's lanes, compare, and reverse back
+                set_layout<V>(regs, transposed, false);
+                const size_t mask = 2 * s / k - 1;
+                for(size_t r = 0; r < network_registers; ++r){
+                    if(r & (s / k)) continue;
+                    typename V::reg upper = V::reverse(regs[r ^ mask]);
+                    compare_exchange<V>(regs[r], upper);
+                    regs[r ^ mask] = V::reverse(upper);
+                }
+            }
+            for(size_t j = s / 2; j >= k && j > 0; j /= 2){ //Half-cleaners between registers
+                set_layout<V>(regs, transposed, false);
+                for(size_t r = 0; r < network_registers; ++r){
+                    if(!(r & (j / k))) compare_exchange<V>(regs[r], regs[r | (j / k)]);
+                }
+            }
+            for(size_t j = (s / 2 < k ? s / 2 : k / 2); j > 0; j /= 2){ //Half-cleaners between lanes
+                set_layout<V>(regs, transposed, true);
+                for(size_t q = 0; q < network_registers; ++q){
+                    if(!(q & j)) compare_exchange<V>(regs[q], regs[q | j]);
+                }
+            }
+        }
+        set_layout<V>(regs, transposed, false);
+    }
+
+    /**
+     * Copies the keys of [first, last) into a padded block, sorts it with the network, and copies the sorted items back
+    */
+    template<typename T>
+    __attribute__((target(CUSTOM_NETWORK_TARGET))) bool sort_block(T* first, T* last){
+        using K = network_key_t<T>;
+        using V = lanes<sizeof(T)>;
+        constexpr size_t items = network_registers * V::count;
+        const size_t length = size_t(last - first);
+
+        alignas(32) K block[items];
+        for(size_t i = 0; i < length; ++i){
+            if constexpr (std::is_floating_point_v<T>){
+                if(first[i] != first[i]) return false; //NaN isn't ordered by operator<, so leave it to insertion sort like the rest of the sort does
+            }
+            block[i] = network_key(first[i]);
+        }
+        for(size_t i = length; i < items; ++i) block[i] = std::numeric_limits<K>::max(); //Above every key, NaN aside, so the padding sorts last
+
+        typename V::reg regs[network_registers];
+        for(size_t r = 0; r < network_registers; ++r) regs[r] = V::load(block + r * V::count);
+        bitonic_network<V>(regs);
+        for(size_t r = 0; r < network_registers; ++r) V::store(block + r * V::count, regs[r]);
+
+        for(size_t i = 0; i < length; ++i) first[i] = network_value<T>(block[i]);
+        return true;
+    }
+
+    template<typename T>
+    inline constexpr network_kernel<T> kernel{std::ptrdiff_t(network_registers * lanes<sizeof(T)>::count), &sort_block<T>};
+}
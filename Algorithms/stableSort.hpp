@@ -0,0 +1,153 @@
+#ifndef STABLESORT
+#define STABLESORT
+#include <algorithm>
+#include <iterator>
+#include <utility>
+#include <vector>
+#include "merge.hpp"
+
+/**
+ * This is my implementation of an adaptive, stable natural merge sort (in the style of Timsort).
+ * The array is scanned for runs that are already in order. Non-decreasing runs are kept as they are, and strictly decreasing runs are reversed
+ * (strictly, so reversing them can't reorder equal items). Runs shorter than a minimum length are extended with binary insertion sort.
+ * Runs are then merged with custom::gallop_merge, keeping the run lengths balanced so every merge is between runs of similar size.
+ *
+ * Stable sorting means if a == b, and a came before b in the input, a still comes before b in the output.
+ * The Time Complexity is O(n log n) in the worst case, and O(n) for inputs made of a few long runs.
+ * The Space Complexity is O(n), for the scratch buffer the left run of each merge is moved into
+*/
+namespace detail{
+    template<typename Iter>
+    struct sorted_run{
+        Iter base;
+        typename std::iterator_traits<Iter>::difference_type length;
+    };
+
+    /**
+     * Finds the end of the run starting at first. Strictly decreasing runs are reversed so every run ends up non-decreasing
+    */
+    template<typename Iter>
+    constexpr Iter count_run(Iter first, Iter last){
+        Iter i = first + 1;
+        if(i == last) return last;
+        if(*i < *first){
+            while(++i != last && *i < *(i - 1));
+            std::reverse(first, i);
+        }
+        else{
+            while(++i != last && !(*i < *(i - 1)));
+        }
+        return i;
+    }
+
+    /**
+     * Insertion sort for extending a run. [first, sorted_end) is already sorted, and each item from sorted_end to last is inserted into it.
+     * The insert position is found with a binary search (after any equal items, to stay stable), which keeps comparisons at O(log n) per item
+    */
+    template<typename Iter>
+    constexpr void binary_insertion_sort(Iter first, Iter sorted_end, Iter last){
+        for(Iter i = sorted_end; i != last; ++i){
+            Iter pos = std::upper_bound(first, i, *i);
+            if(pos == i) continue;
+            typename std::iterator_traits<Iter>::value_type val = std::move(*i);
+            std::move_backward(pos, i, i + 1);
+            *pos = std::move(val);
+        }
+    }
+
+    /**
+     * Picks a minimum run length in [32, 64] so that n / min_run is a power of 2 or just below one, which keeps the final merges balanced
+    */
+    template<typename Distance>
+    constexpr Distance min_run_length(Distance n){
+        Distance extra = 0;
+        while(n >= 64){
+            extra |= n & 1;
+            n >>= 1;
+        }
+        return n + extra;
+    }
+
+    /**
+     * Merges two neighbouring runs [first, mid) and [mid, last).
+     * Items at the front of the left run that are <= the first item of the right run, and items at the back of the right run that are >= the last item
+     * of the left run, are already in place and are skipped. What is left of the left run is moved into the buffer and merged back into the array
+    */
+    template<typename Iter>
+    void merge_runs(Iter first, Iter mid, Iter last, std::vector<typename std::iterator_traits<Iter>::value_type>& buffer){
+        first = detail::gallop_upper_bound(first, mid, *mid);
+        if(first == mid) return; //The two runs are already in order
+        last = detail::gallop_lower_bound(mid, last, *(mid - 1));
+
+        buffer.assign(std::make_move_iterator(first), std::make_move_iterator(mid));
+        //The output trails the unread part of the right run, so merging into the array in place is safe.
+        //Once the buffer is used up, the rest of the right run is already in place
+        auto stopped = detail::gallop_merge_loop(std::make_move_iterator(buffer.begin()), std::make_move_iterator(buffer.end()),
+                                                 std::make_move_iterator(mid), std::make_move_iterator(last), first);
+        std::copy(std::get<0>(stopped), std::make_move_iterator(buffer.end()), std::get<2>(stopped));
+        buffer.clear();
+    }
+
+    /**
+     * Merges runs at the top of the stack until the lengths satisfy the Timsort invariants:
+     * each run is longer than the sum of the two runs above it, and longer than the run above it.
+     * This keeps the stack O(log n) deep and every merge balanced
+    */
+    template<typename Iter>
+    void merge_collapse(std::vector<sorted_run<Iter>>& runs, std::vector<typename std::iterator_traits<Iter>::value_type>& buffer, bool force){
+        while(runs.size() > 1){
+            size_t n = runs.size() - 2;
+            if(force){
+                if(n > 0 && runs[n - 1].length < runs[n + 1].length) --n;
+            }
+            else if((n > 0 && runs[n - 1].length <= runs[n].length + runs[n + 1].length)
+                    || (n > 1 && runs[n - 2].length <= runs[n - 1].length + runs[n].length)){
+                if(runs[n - 1].length < runs[n + 1].length) --n; //Merge the smaller neighbour into the middle run
+            }
+            else if(runs[n].length > runs[n + 1].length) return; //The invariants hold
+
+            detail::merge_runs(runs[n].base, runs[n + 1].base, runs[n + 1].base + runs[n + 1].length, buffer);
+            runs[n].length += runs[n + 1].length;
+            runs.erase(runs.begin() + (n + 1));
+        }
+    }
+}
+
+/**
+ * Entry Point for user is custom::stable_sort
+*/
+namespace custom{
+    /**
+     * Stable sort that reuses @param buffer as its scratch space, so repeated sorts don't have to allocate.
+     * The buffer is left empty but keeps its capacity
+    */
+    template<typename Iter>
+    void stable_sort(Iter first, Iter last, std::vector<typename std::iterator_traits<Iter>::value_type>& buffer){
+        typedef typename std::iterator_traits<Iter>::difference_type DistanceType;
+        const DistanceType length = last - first;
+        if(length < 2) return;
+
+        const DistanceType min_run = detail::min_run_length(length);
+        std::vector<detail::sorted_run<Iter>> runs;
+        Iter run_start = first;
+        while(run_start != last){
+            Iter run_end = detail::count_run(run_start, last);
+            if(run_end - run_start < min_run){ //Too short, extend it to min_run items with insertion sort (which is stable)
+                Iter sorted_end = run_end;
+                run_end = last - run_start > min_run ? run_start + min_run : last;
+                detail::binary_insertion_sort(run_start, sorted_end, run_end);
+            }
+            runs.push_back({run_start, run_end - run_start});
+            detail::merge_collapse(runs, buffer, false);
+            run_start = run_end;
+        }
+        detail::merge_collapse(runs, buffer, true);
+    }
+
+    template<typename Iter>
+    void stable_sort(Iter first, Iter last){
+        std::vector<typename std::iterator_traits<Iter>::value_type> buffer;
+        custom::stable_sort(first, last, buffer);
+    }
+}
+#endif //STABLESORT
@@ -0,0 +1,251 @@
+#ifndef THREADPOOL
+#define THREADPOOL
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/**
+ * This is my work-stealing thread pool, used by the parallel overloads of the algorithms in this folder.
+ * Every worker owns a double-ended task queue. A worker pushes and pops tasks at the back of its own queue (newest first, which keeps
+ * the data it just touched in cache), and when its queue runs dry it steals the oldest task from the front of another worker's queue.
+ * Old tasks are usually the biggest pieces of work (e.g. the first partitions of a sort), so a single steal hands off a lot of work.
+ *
+ * Threads outside of the pool that are waiting on work (see custom::taskGroup) help run tasks instead of blocking, so nested
+ * parallel calls can never deadlock the pool.
+*/
+namespace custom{
+    class threadPool{
+    public:
+        using task_type = std::function<void()>;
+
+        /**
+         * Worker constructor
+         * Starts @param workers threads. Defaults to one thread per hardware thread
+        */
+        explicit threadPool(size_t workers = std::thread::hardware_concurrency()) {
+            if(workers == 0) workers = 1; //hardware_concurrency is allowed to return 0 when it can't tell
+            m_queues.reserve(workers + 1);
+            for(size_t i = 0; i <= workers; ++i){ //The extra queue takes tasks submitted from threads outside of the pool
+                m_queues.push_back(std::make_unique<taskQueue>());
+            }
+            m_threads.reserve(workers);
+            for(size_t i = 0; i < workers; ++i){
+                m_threads.emplace_back([this, i]{ workerLoop(i); });
+            }
+        }
+
+        threadPool(const threadPool&) = delete;
+        threadPool& operator=(const threadPool&) = delete;
+
+        /**
+         * Destructor
+         * Wakes up and joins every worker. Tasks still queued at this point are dropped
+        */
+        ~threadPool(){
+            {
+                std::lock_guard<std::mutex> lock(m_sleepMutex);
+                m_stop = true;
+            }
+            m_wake.notify_all();
+            for(std::thread& t : m_threads) t.join();
+        }
+
+        /**
+         * Returns a pool shared by the whole program, created on first use with one worker per hardware thread
+        */
+        static threadPool& shared(){
+            static threadPool pool;
+            return pool;
+        }
+
+        /**
+         * Queues a task.
+         * Tasks submitted by one of this pool's workers go to the back of that worker's own queue, anything else goes to the shared queue
+        */
+        template<class F>
+        void submit(F&& task){
+            const size_t index = t_owner == this ? t_index : m_threads.size();
+            {
+                std::lock_guard<std::mutex> lock(m_queues[index]->mutex);
+                m_queues[index]->tasks.emplace_back(std::forward<F>(task));
+            }
+            {
+                std::lock_guard<std::mutex> lock(m_sleepMutex); //Taking the lock before notifying makes sure a worker about to sleep can't miss this task
+                ++m_queued;
+            }
+            m_wake.notify_one();
+        }
+
+        /**
+         * Runs a single queued task on the calling thread, if one can be found.
+         * Returns false if every queue was empty
+        */
+        bool try_run_one(){
+            task_type task;
+            if(!take(t_owner == this ? t_index : m_threads.size(), task)) return false;
+            task();
+            return true;
+        }
+
+        /**
+         * Returns the number of worker threads
+        */
+        size_t size() const noexcept { return m_threads.size(); }
+
+    private:
+        struct taskQueue{
+            std::mutex mutex;
+            std::deque<task_type> tasks;
+        };
+
+        std::vector<std::unique_ptr<taskQueue>> m_queues; //One queue per worker, plus the shared queue at the back
+        std::vector<std::thread> m_threads;
+        std::mutex m_sleepMutex; //Guards m_queued and m_stop for sleeping workers
+        std::condition_variable m_wake;
+        size_t m_queued = 0; //Number of tasks sitting in any queue
+        bool m_stop = false;
+
+        inline static thread_local threadPool* t_owner = nullptr; //The pool the current thread works for, if any
+        inline static thread_local size_t t_index = 0; //The current worker's queue index
+
+        /**
+         * Pops the newest task from the queue at @param home, otherwise steals the oldest task from the other queues
+        */
+        bool take(size_t home, task_type& task){
+            if(popBack(*m_queues[home], task)) return true;
+            for(size_t i = 1; i < m_queues.size(); ++i){
+                if(popFront(*m_queues[(home + i) % m_queues.size()], task)) return true;
+            }
+            return false;
+        }
+
+        bool popBack(taskQueue& queue, task_type& task){
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if(queue.tasks.empty()) return false;
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+            taken();
+            return true;
+        }
+
+        bool popFront(taskQueue& queue, task_type& task){
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if(queue.tasks.empty()) return false;
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+            taken();
+            return true;
+        }
+
+        void taken(){
+            std::lock_guard<std::mutex> lock(m_sleepMutex);
+            --m_queued;
+        }
+
+        /**
+         * Worker thread body. Runs tasks until the pool is destroyed, sleeping whenever every queue is empty
+        */
+        void workerLoop(size_t index){
+            t_owner = this;
+            t_index = index;
+            task_type task;
+            while(true){
+                if(take(index, task)){
+                    task();
+                    task = nullptr; //Release whatever the task captured before looking for more work
+                    continue;
+                }
+                std::unique_lock<std::mutex> lock(m_sleepMutex);
+                m_wake.wait(lock, [this]{ return m_stop || m_queued > 0; });
+                if(m_stop) return;
+            }
+        }
+    };
+
+    /**
+     * A group of tasks run on a threadPool that can be waited on together.
+     * wait() runs queued tasks on the waiting thread until every task in the group has finished, then rethrows the first exception
+     * thrown by any of them
+    */
+    class taskGroup{
+    public:
+        explicit taskGroup(threadPool& pool) : m_pool(pool) {}
+
+        taskGroup(const taskGroup&) = delete;
+        taskGroup& operator=(const taskGroup&) = delete;
+
+        ~taskGroup(){
+            while(m_outstanding.load(std::memory_order_acquire) != 0){ //Never let queued tasks outlive the group they report to
+                if(!m_pool.try_run_one()) std::this_thread::yield();
+            }
+        }
+
+        /**
+         * Queues @param task on the pool as part of this group
+        */
+        template<class F>
+        void run(F&& task){
+            m_outstanding.fetch_add(1, std::memory_order_relaxed);
+            try{
+                m_pool.submit([this, task = std::forward<F>(task)]() mutable {
+                    try{
+                        task();
+                    }
+                    catch(...){
+                        std::lock_guard<std::mutex> lock(m_exceptionMutex);
+                        if(!m_exception) m_exception = std::current_exception();
+                    }
+                    m_outstanding.fetch_sub(1, std::memory_order_release); //Must be the last use of this, the group may be destroyed right after
+                });
+            }
+            catch(...){ //The task never made it into a queue
+                m_outstanding.fetch_sub(1, std::memory_order_relaxed);
+                throw;
+            }
+        }
+
+        /**
+         * Helps run tasks until every task in the group has finished
+        */
+        void wait(){
+            while(m_outstanding.load(std::memory_order_acquire) != 0){
+                if(!m_pool.try_run_one()) std::this_thread::yield();
+            }
+            if(m_exception) std::rethrow_exception(std::exchange(m_exception, nullptr));
+        }
+
+        threadPool& pool() noexcept { return m_pool; }
+
+    private:
+        threadPool& m_pool;
+        std::atomic<size_t> m_outstanding{0};
+        std::mutex m_exceptionMutex;
+        std::exception_ptr m_exception;
+    };
+
+    /**
+     * Execution policies used to pick the parallel overloads, e.g. custom::sort(custom::execution::par, first, last).
+     * By default the shared pool is used. To control the number of workers, build a threadPool and pass it with par.on(pool)
+    */
+    namespace execution{
+        struct parallel_policy{
+            threadPool* pool = nullptr; //nullptr means threadPool::shared()
+            size_t grain = 1 << 15; //Ranges of this many elements or fewer are handled serially by a single task
+
+            constexpr parallel_policy on(threadPool& p) const noexcept { return parallel_policy{&p, grain}; }
+            constexpr parallel_policy with_grain(size_t g) const noexcept { return parallel_policy{pool, g == 0 ? 1 : g}; }
+            threadPool& get_pool() const { return pool ? *pool : threadPool::shared(); }
+        };
+
+        inline constexpr parallel_policy par{};
+    }
+}
+#endif //THREADPOOL
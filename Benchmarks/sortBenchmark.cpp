@@ -0,0 +1,307 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "merge.hpp"
+#include "sort.hpp"
+
+/**
+ * Benchmarks custom::sort and custom::merge against std::sort and std::merge.
+ * Every combination of element type, input distribution and size is run, and the time (ns/element) and the number of
+ * operator< calls (comparisons/element) are reported for each algorithm.
+ *
+ * Time is measured on the plain element type, so int and double go through the radix sort and sorting network fast paths where custom::sort has them.
+ * Comparisons are counted by running the algorithm once more on a wrapper type whose operator< counts calls. The wrapper isn't arithmetic,
+ * so for int and double the count is for the comparison sort (introsort) path, and radix sort itself makes no comparisons.
+ *
+ * The merge benchmarks split each generated input in half, sort each half, and time merging the halves into an output array.
+ *
+ * Usage: sortBenchmark [options]
+ *     --sizes 10,1000,...        Sizes to run. Defaults to every power of 10 from 10 up to --max-size
+ *     --max-size N               Largest default size (1000000). Sizes up to 100000000 work if there is enough memory
+ *     --types int,double,...     Any of int, double, string, record64
+ *     --distributions a,b,...    Any of random, sorted, reversed, organ-pipe, few-unique, sawtooth, all-equal
+ *     --algorithms sort,merge    Which comparisons to run
+ *     --min-time MS              Repeat each measurement until it has run for at least this long (100)
+ *     --seed N                   Seed for the random distributions
+ *     --no-count                 Skip counting comparisons, which halves the run time
+ *     --csv                      Print comma-separated values instead of a table
+*/
+namespace{
+    //Element types -------------------------------------------------------------------------------
+
+    /**
+     * A 64 byte record sorted on its first field, standing in for the structs sorted in real code
+    */
+    struct record64{
+        std::uint64_t key;
+        std::array<std::uint64_t, 7> payload;
+
+        friend bool operator<(const record64& a, const record64& b) noexcept { return a.key < b.key; }
+        friend bool operator==(const record64& a, const record64& b) noexcept { return a.key == b.key; }
+    };
+    static_assert(sizeof(record64) == 64);
+
+    /**
+     * Turns a generated key into an element. Keys are below 2^31, and every conversion keeps their order
+    */
+    template<typename T> T make_element(std::uint32_t key);
+    template<> int make_element<int>(std::uint32_t key){ return int(key); }
+    template<> double make_element<double>(std::uint32_t key){ return double(key) * 0.5; }
+    template<> std::string make_element<std::string>(std::uint32_t key){
+        char text[16];
+        std::snprintf(text, sizeof(text), "%010u", unsigned(key)); //Zero padded so string order matches key order. Short enough for the small string buffer
+        return text;
+    }
+    template<> record64 make_element<record64>(std::uint32_t key){ return record64{key, {key, key, key, key, key, key, key}}; }
+
+    std::size_t comparisons = 0;
+
+    /**
+     * Wraps an element and counts every call to operator<
+    */
+    template<typename T>
+    struct counted{
+        T value;
+
+        friend bool operator<(const counted& a, const counted& b){
+            ++comparisons;
+            return a.value < b.value;
+        }
+    };
+
+    //Distributions -------------------------------------------------------------------------------
+
+    const std::vector<std::string> distribution_names = {"random", "sorted", "reversed", "organ-pipe", "few-unique", "sawtooth", "all-equal"};
+
+    std::vector<std::uint32_t> make_keys(const std::string& distribution, std::size_t n, std::uint64_t seed){
+        std::vector<std::uint32_t> keys(n);
+        std::mt19937_64 rng(seed ^ n);
+        const std::size_t tooth = std::max<std::size_t>(2, n / 16); //16 ascending runs
+        for(std::size_t i = 0; i < n; ++i){
+            std::uint64_t key;
+            if(distribution == "random") key = rng() >> 33;
+            else if(distribution == "sorted") key = i;
+            else if(distribution == "reversed") key = n - 1 - i;
+            else if(distribution == "organ-pipe") key = i < n / 2 ? i : n - 1 - i;
+            else if(distribution == "few-unique") key = rng() % 16;
+            else if(distribution == "sawtooth") key = i % tooth;
+            else if(distribution == "all-equal") key = 42;
+            else throw std::invalid_argument("Unknown distribution " + distribution);
+            keys[i] = std::uint32_t(key);
+        }
+        return keys;
+    }
+
+    //Measurement ---------------------------------------------------------------------------------
+
+    struct options{
+        std::vector<std::size_t> sizes;
+        std::size_t max_size = 1000000;
+        std::vector<std::string> types = {"int", "double", "string", "record64"};
+        std::vector<std::string> distributions = distribution_names;
+        std::vector<std::string> algorithms = {"sort", "merge"};
+        double min_time = 0.1; //Seconds
+        std::uint64_t seed = 1;
+        bool count = true;
+        bool csv = false;
+    };
+
+    /**
+     * Several unsorted inputs of the same size and distribution laid out back to back, so small sizes can be timed many at a time instead of
+     * one timer call per tiny sort. Each copy is generated with its own seed: sorting the same few random items over and over lets the branch
+     * predictor learn them, which makes small sorts look far faster than they are
+    */
+    template<typename T>
+    struct batch{
+        std::vector<T> input;
+        std::size_t n;
+        std::size_t copies;
+    };
+
+    template<typename T>
+    batch<T> make_batch(const std::string& distribution, std::size_t n, std::uint64_t seed){
+        const std::size_t copies = std::max<std::size_t>(1, (std::size_t(1) << 16) / std::max<std::size_t>(1, n));
+        batch<T> result{{}, n, copies};
+        result.input.reserve(n * copies);
+        for(std::size_t c = 0; c < copies; ++c){
+            for(std::uint32_t key : make_keys(distribution, n, seed + c)) result.input.push_back(make_element<T>(key));
+        }
+        return result;
+    }
+
+    /**
+     * Runs @param run on a fresh copy of the batch until min_time has passed, and returns the average ns/element.
+     * Refreshing the copy isn't timed
+    */
+    template<typename T, class Run>
+    double time_per_element(const batch<T>& input, const options& opts, Run run){
+        using clock = std::chrono::steady_clock;
+        std::vector<T> work;
+        double total = 0;
+        std::size_t elements = 0;
+        do{
+            work = input.input;
+            const clock::time_point start = clock::now();
+            for(std::size_t c = 0; c < input.copies; ++c) run(work.data() + c * input.n, input.n);
+            total += std::chrono::duration<double>(clock::now() - start).count();
+            elements += input.n * input.copies;
+        } while(total < opts.min_time);
+        return total * 1e9 / double(elements);
+    }
+
+    void print_row(const options& opts, const std::string& type, const std::string& distribution, std::size_t n, const char* algorithm, double ns, double cmp){
+        if(opts.csv && cmp < 0) std::printf("%s,%s,%zu,%s,%.3f,\n", type.c_str(), distribution.c_str(), n, algorithm, ns);
+        else if(opts.csv) std::printf("%s,%s,%zu,%s,%.3f,%.3f\n", type.c_str(), distribution.c_str(), n, algorithm, ns, cmp);
+        else if(cmp < 0) std::printf("%-9s %-11s %10zu %-13s %10.2f %10s\n", type.c_str(), distribution.c_str(), n, algorithm, ns, "-");
+        else std::printf("%-9s %-11s %10zu %-13s %10.2f %10.2f\n", type.c_str(), distribution.c_str(), n, algorithm, ns, cmp);
+        std::fflush(stdout);
+    }
+
+    /**
+     * Counts the comparisons @param run makes on one copy of the input. Returns -1 if counting is turned off
+    */
+    template<typename T, class Run>
+    double comparisons_per_element(const std::vector<T>& input, const options& opts, Run run){
+        if(!opts.count || input.empty()) return -1;
+        std::vector<counted<T>> work;
+        work.reserve(input.size());
+        for(const T& item : input) work.push_back(counted<T>{item});
+        comparisons = 0;
+        run(work.data(), work.size());
+        return double(comparisons) / double(input.size());
+    }
+
+    template<typename T>
+    void bench_sort(const options& opts, const std::string& type, const std::string& distribution, const batch<T>& copies){
+        const std::vector<T> input(copies.input.begin(), copies.input.begin() + copies.n);
+        auto custom_sort = [](auto* data, std::size_t n){ custom::sort(data, data + n); };
+        auto std_sort = [](auto* data, std::size_t n){ std::sort(data, data + n); };
+
+        std::vector<T> check(input);
+        custom::sort(check.begin(), check.end());
+        if(!std::is_sorted(check.begin(), check.end())) throw std::logic_error("custom::sort left " + type + "/" + distribution + " unsorted");
+
+        print_row(opts, type, distribution, input.size(), "custom::sort", time_per_element(copies, opts, custom_sort), comparisons_per_element(input, opts, custom_sort));
+        print_row(opts, type, distribution, input.size(), "std::sort", time_per_element(copies, opts, std_sort), comparisons_per_element(input, opts, std_sort));
+    }
+
+    template<typename T>
+    void bench_merge(const options& opts, const std::string& type, const std::string& distribution, batch<T> copies){
+        const std::size_t half = copies.n / 2;
+        for(std::size_t c = 0; c < copies.copies; ++c){ //Merging needs two sorted halves
+            const auto first = copies.input.begin() + c * copies.n;
+            std::sort(first, first + half);
+            std::sort(first + half, first + copies.n);
+        }
+        const std::vector<T> input(copies.input.begin(), copies.input.begin() + copies.n);
+
+        std::vector<T> output(input.size());
+        auto custom_merge = [half, &output](auto* data, std::size_t n){ custom::merge(data, data + half, data + half, data + n, output.data()); };
+        auto std_merge = [half, &output](auto* data, std::size_t n){ std::merge(data, data + half, data + half, data + n, output.data()); };
+        //The counting runs merge counted<T> items, so they need their own output
+        auto count_custom = [half](auto* data, std::size_t n){
+            std::vector<std::remove_pointer_t<decltype(data)>> out(n);
+            custom::merge(data, data + half, data + half, data + n, out.data());
+        };
+        auto count_std = [half](auto* data, std::size_t n){
+            std::vector<std::remove_pointer_t<decltype(data)>> out(n);
+            std::merge(data, data + half, data + half, data + n, out.data());
+        };
+
+        custom_merge(input.data(), input.size());
+        if(!std::is_sorted(output.begin(), output.end())) throw std::logic_error("custom::merge left " + type + "/" + distribution + " unsorted");
+
+        print_row(opts, type, distribution, input.size(), "custom::merge", time_per_element(copies, opts, custom_merge), comparisons_per_element(input, opts, count_custom));
+        print_row(opts, type, distribution, input.size(), "std::merge", time_per_element(copies, opts, std_merge), comparisons_per_element(input, opts, count_std));
+    }
+
+    template<typename T>
+    void bench_type(const options& opts, const std::string& type){
+        for(std::size_t n : opts.sizes){
+            for(const std::string& distribution : opts.distributions){
+                const batch<T> copies = make_batch<T>(distribution, n, opts.seed);
+                for(const std::string& algorithm : opts.algorithms){
+                    if(algorithm == "sort") bench_sort(opts, type, distribution, copies);
+                    else if(algorithm == "merge") bench_merge(opts, type, distribution, copies);
+                    else throw std::invalid_argument("Unknown algorithm " + algorithm);
+                }
+            }
+        }
+    }
+
+    //Command line --------------------------------------------------------------------------------
+
+    std::vector<std::string> split(const std::string& list){
+        std::vector<std::string> items;
+        std::size_t start = 0;
+        while(start <= list.size()){
+            const std::size_t end = std::min(list.find(',', start), list.size());
+            if(end > start) items.push_back(list.substr(start, end - start));
+            start = end + 1;
+        }
+        return items;
+    }
+
+    std::size_t parse_size(const std::string& text){
+        const double value = std::stod(text); //Accepts 1e8 as well as 100000000
+        if(!(value >= 0) || value != std::floor(value)) throw std::invalid_argument("Bad size " + text);
+        return std::size_t(value);
+    }
+
+    options parse(int argc, char** argv){
+        options opts;
+        for(int i = 1; i < argc; ++i){
+            const std::string arg = argv[i];
+            auto value = [&]() -> std::string {
+                if(i + 1 >= argc) throw std::invalid_argument(arg + " needs a value");
+                return argv[++i];
+            };
+            if(arg == "--sizes"){
+                for(const std::string& size : split(value())) opts.sizes.push_back(parse_size(size));
+            }
+            else if(arg == "--max-size") opts.max_size = parse_size(value());
+            else if(arg == "--types") opts.types = split(value());
+            else if(arg == "--distributions") opts.distributions = split(value());
+            else if(arg == "--algorithms") opts.algorithms = split(value());
+            else if(arg == "--min-time") opts.min_time = std::stod(value()) / 1000;
+            else if(arg == "--seed") opts.seed = std::stoull(value());
+            else if(arg == "--no-count") opts.count = false;
+            else if(arg == "--csv") opts.csv = true;
+            else throw std::invalid_argument("Unknown option " + arg);
+        }
+        if(opts.sizes.empty()){
+            for(std::size_t n = 10; n <= opts.max_size; n *= 10) opts.sizes.push_back(n);
+        }
+        return opts;
+    }
+}
+
+int main(int argc, char** argv){
+    try{
+        const options opts = parse(argc, argv);
+        if(opts.csv) std::printf("type,distribution,size,algorithm,ns_per_element,comparisons_per_element\n");
+        else std::printf("%-9s %-11s %10s %-13s %10s %10s\n", "type", "distribution", "size", "algorithm", "ns/elem", "cmp/elem");
+        for(const std::string& type : opts.types){
+            if(type == "int") bench_type<int>(opts, type);
+            else if(type == "double") bench_type<double>(opts, type);
+            else if(type == "string") bench_type<std::string>(opts, type);
+            else if(type == "record64") bench_type<record64>(opts, type);
+            else throw std::invalid_argument("Unknown type " + type);
+        }
+    }
+    catch(const std::exception& e){
+        std::fprintf(stderr, "sortBenchmark: %s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,406 @@
+#ifndef ALLOCATORS
+#define ALLOCATORS
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <new>
+#include <type_traits>
+#include <utility>
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+/**
+ * Allocators for custom::myVector (or any standard container) that avoid going to the global heap for every allocation.
+ *
+ * custom::monotonicArena hands out memory by bumping a pointer through large chunks, and never frees anything until the whole arena is released
+ * or destroyed. It suits short-lived scratch containers, e.g. everything built while handling one request, which can then be thrown away in one go.
+ *
+ * custom::fixedPool hands out blocks of one fixed size from a free list, so freed blocks are reused right away without touching the global heap.
+ * Requests bigger than a block fall through to operator new. It suits many small containers that are created and destroyed over and over.
+ *
+ * custom::arenaAllocator and custom::poolAllocator are the typed allocators that point at them. Like std::pmr::polymorphic_allocator, they stay with
+ * the container they were given to: copying, moving or swapping containers never moves an allocator to another container.
+ * Neither resource is thread safe, so use one per thread (or per request)
+ *
+ * custom::alignedAllocator and custom::hugePageAllocator are stateless instead, and change where buffers start rather than where they come from.
+ * alignedAllocator aligns every buffer to Alignment bytes (64, a cache line, by default), so SIMD loops can use aligned loads without peeling
+ * and ranges split on cache line boundaries never share a line. hugePageAllocator also maps big buffers straight from the kernel,
+ * 2 MB aligned and marked with madvise(MADV_HUGEPAGE), so scanning gigabytes takes 512 times fewer TLB entries
+*/
+namespace detail{
+    inline size_t align_up(size_t value, size_t alignment) noexcept {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+
+    /**
+     * Converts a count of T into bytes, throwing instead of wrapping around
+    */
+    template<typename T>
+    size_t allocation_bytes(size_t count){
+        if(count > std::numeric_limits<size_t>::max() / sizeof(T)) throw std::bad_array_new_length();
+        return count * sizeof(T);
+    }
+
+    inline constexpr size_t huge_page_size = size_t(2) << 20; //Transparent huge pages on x86-64 and most ARM64 kernels
+
+    /**
+     * True for allocators that want their big buffers backed by huge pages. myVector maps such buffers itself, so they can grow with mremap
+    */
+    template<class Allocator>
+    concept huge_page_allocator = requires { requires Allocator::huge_pages; };
+}
+
+namespace custom{
+    //Monotonic Arena Section ------------------------------------------------------------------------
+
+    /**
+     * A bump allocator. Memory comes from chunks that grow geometrically, and deallocate does nothing.
+     * release() (or the destructor) frees every chunk at once
+    */
+    class monotonicArena{
+    public:
+        /**
+         * Chunk size constructor
+         * The first chunk is allocated on first use and holds @param initialSize bytes. Every chunk after that is twice as big as the one before
+        */
+        explicit monotonicArena(size_t initialSize = 4096) noexcept : m_nextSize(std::max<size_t>(initialSize, 64)) {}
+
+        /**
+         * Buffer constructor
+         * Allocates from @param buffer first (e.g. an array on the stack), and only asks the heap for chunks once it is used up.
+         * The buffer is not owned by the arena
+        */
+        monotonicArena(void* buffer, size_t size) noexcept
+            : m_initial(static_cast<std::byte*>(buffer)), m_initialSize(size), m_current(m_initial), m_remaining(size), m_nextSize(std::max<size_t>(size, 64)) {}
+
+        monotonicArena(const monotonicArena&) = delete;
+        monotonicArena& operator=(const monotonicArena&) = delete;
+
+        ~monotonicArena(){ freeChunks(); }
+
+        /**
+         * Returns @param bytes bytes aligned to @param alignment (a power of 2)
+        */
+        void* allocate(size_t bytes, size_t alignment = alignof(std::max_align_t)){
+            if(bytes == 0) bytes = 1; //Every allocation gets its own address
+            size_t padding = paddingFor(alignment);
+            if(m_remaining < bytes || m_remaining - bytes < padding){
+                newChunk(bytes, alignment);
+                padding = paddingFor(alignment);
+            }
+            std::byte* result = m_current + padding;
+            m_current = result + bytes;
+            m_remaining -= padding + bytes;
+            return result;
+        }
+
+        void deallocate(void*, size_t) noexcept {} //Memory only comes back when the arena is released
+
+        /**
+         * Frees every chunk and starts over from the initial buffer, if there is one.
+         * Every pointer handed out by the arena is invalid afterwards
+        */
+        void release() noexcept {
+            freeChunks();
+            m_current = m_initial;
+            m_remaining = m_initialSize;
+        }
+
+        /**
+         * Returns the number of bytes held in chunks from the heap
+        */
+        size_t chunk_bytes() const noexcept { return m_chunkBytes; }
+
+    private:
+        struct chunk{
+            chunk* next;
+            size_t size; //Bytes including this header
+        };
+
+        std::byte* m_initial = nullptr;
+        size_t m_initialSize = 0;
+        std::byte* m_current = nullptr;
+        size_t m_remaining = 0;
+        size_t m_nextSize;
+        size_t m_chunkBytes = 0;
+        chunk* m_chunks = nullptr; //Newest chunk first
+
+        size_t paddingFor(size_t alignment) const noexcept {
+            const std::uintptr_t address = reinterpret_cast<std::uintptr_t>(m_current);
+            return detail::align_up(address, alignment) - address;
+        }
+
+        /**
+         * Allocates a chunk big enough for @param bytes at @param alignment. Anything left in the current chunk is abandoned
+        */
+        void newChunk(size_t bytes, size_t alignment){
+            const size_t header = detail::align_up(sizeof(chunk), alignof(std::max_align_t));
+            if(bytes > std::numeric_limits<size_t>::max() / 2 - header - alignment) throw std::bad_alloc();
+            const size_t size = std::max(m_nextSize, header + bytes + alignment);
+            chunk* c = static_cast<chunk*>(::operator new(size));
+            c->next = m_chunks;
+            c->size = size;
+            m_chunks = c;
+            m_chunkBytes += size;
+            m_current = reinterpret_cast<std::byte*>(c) + header;
+            m_remaining = size - header;
+            m_nextSize = size < std::numeric_limits<size_t>::max() / 2 ? size * 2 : size; //Geometric growth keeps the number of chunks O(log n)
+        }
+
+        void freeChunks() noexcept {
+            while(m_chunks){
+                chunk* next = m_chunks->next;
+                ::operator delete(m_chunks, m_chunks->size);
+                m_chunks = next;
+            }
+            m_chunkBytes = 0;
+        }
+    };
+
+    /**
+     * The allocator that points at a monotonicArena. The arena must outlive every container using it
+    */
+    template<typename T>
+    class arenaAllocator{
+    public:
+        using value_type = T;
+        using propagate_on_container_copy_assignment = std::false_type;
+        using propagate_on_container_move_assignment = std::false_type;
+        using propagate_on_container_swap = std::false_type;
+        using is_always_equal = std::false_type;
+
+        arenaAllocator(monotonicArena& arena) noexcept : m_arena(&arena) {}
+
+        template<typename U>
+        arenaAllocator(const arenaAllocator<U>& other) noexcept : m_arena(other.arena()) {}
+
+        [[nodiscard]] T* allocate(size_t count){
+            return static_cast<T*>(m_arena->allocate(detail::allocation_bytes<T>(count), alignof(T)));
+        }
+
+        void deallocate(T* p, size_t count) noexcept { m_arena->deallocate(p, count * sizeof(T)); }
+
+        monotonicArena* arena() const noexcept { return m_arena; }
+
+        template<typename U>
+        bool operator==(const arenaAllocator<U>& other) const noexcept { return m_arena == other.arena(); }
+
+    private:
+        monotonicArena* m_arena;
+    };
+    //End Monotonic Arena Section --------------------------------------------------------------------
+
+    //Fixed-Size Pool Section ------------------------------------------------------------------------
+
+    /**
+     * A pool of equally sized blocks. Free blocks are kept in a singly linked list threaded through the blocks themselves,
+     * so allocate and deallocate are a couple of pointer moves. Blocks are carved out of chunks of @param blocksPerChunk blocks at a time,
+     * and the chunks are only returned to the heap when the pool is destroyed
+    */
+    class fixedPool{
+    public:
+        /**
+         * Block size constructor
+         * Serves allocations of up to @param blockSize bytes, aligned to at most alignof(std::max_align_t)
+        */
+        explicit fixedPool(size_t blockSize, size_t blocksPerChunk = 64) noexcept
+            : m_blockSize(detail::align_up(std::max(blockSize, sizeof(freeBlock)), alignof(std::max_align_t))), m_blocksPerChunk(std::max<size_t>(blocksPerChunk, 1)) {}
+
+        fixedPool(const fixedPool&) = delete;
+        fixedPool& operator=(const fixedPool&) = delete;
+
+        ~fixedPool(){
+            while(m_chunks){
+                chunk* next = m_chunks->next;
+                ::operator delete(m_chunks, m_chunks->size);
+                m_chunks = next;
+            }
+        }
+
+        void* allocate(size_t bytes, size_t alignment = alignof(std::max_align_t)){
+            if(bytes > m_blockSize || alignment > alignof(std::max_align_t)) return ::operator new(bytes, std::align_val_t(std::max(alignment, alignof(std::max_align_t))));
+            if(!m_free) newChunk();
+            freeBlock* block = m_free;
+            m_free = block->next;
+            return block;
+        }
+
+        void deallocate(void* p, size_t bytes, size_t alignment = alignof(std::max_align_t)) noexcept {
+            if(bytes > m_blockSize || alignment > alignof(std::max_align_t)){
+                ::operator delete(p, bytes, std::align_val_t(std::max(alignment, alignof(std::max_align_t))));
+                return;
+            }
+            freeBlock* block = static_cast<freeBlock*>(p);
+            block->next = m_free;
+            m_free = block;
+        }
+
+        size_t block_size() const noexcept { return m_blockSize; }
+
+    private:
+        struct freeBlock{
+            freeBlock* next;
+        };
+        struct chunk{
+            chunk* next;
+            size_t size;
+        };
+
+        size_t m_blockSize;
+        size_t m_blocksPerChunk;
+        freeBlock* m_free = nullptr;
+        chunk* m_chunks = nullptr;
+
+        void newChunk(){
+            const size_t header = detail::align_up(sizeof(chunk), alignof(std::max_align_t));
+            const size_t size = header + m_blockSize * m_blocksPerChunk;
+            chunk* c = static_cast<chunk*>(::operator new(size));
+            c->next = m_chunks;
+            c->size = size;
+            m_chunks = c;
+            std::byte* blocks = reinterpret_cast<std::byte*>(c) + header;
+            for(size_t i = m_blocksPerChunk; i-- > 0;){ //Pushed in reverse so blocks are handed out in address order
+                freeBlock* block = reinterpret_cast<freeBlock*>(blocks + i * m_blockSize);
+                block->next = m_free;
+                m_free = block;
+            }
+        }
+    };
+
+    /**
+     * The allocator that points at a fixedPool. The pool must outlive every container using it
+    */
+    template<typename T>
+    class poolAllocator{
+    public:
+        using value_type = T;
+        using propagate_on_container_copy_assignment = std::false_type;
+        using propagate_on_container_move_assignment = std::false_type;
+        using propagate_on_container_swap = std::false_type;
+        using is_always_equal = std::false_type;
+
+        poolAllocator(fixedPool& pool) noexcept : m_pool(&pool) {}
+
+        template<typename U>
+        poolAllocator(const poolAllocator<U>& other) noexcept : m_pool(other.pool()) {}
+
+        [[nodiscard]] T* allocate(size_t count){
+            return static_cast<T*>(m_pool->allocate(detail::allocation_bytes<T>(count), alignof(T)));
+        }
+
+        void deallocate(T* p, size_t count) noexcept { m_pool->deallocate(p, count * sizeof(T), alignof(T)); }
+
+        fixedPool* pool() const noexcept { return m_pool; }
+
+        template<typename U>
+        bool operator==(const poolAllocator<U>& other) const noexcept { return m_pool == other.pool(); }
+
+    private:
+        fixedPool* m_pool;
+    };
+    //End Fixed-Size Pool Section --------------------------------------------------------------------
+
+    //Aligned Allocator Section ----------------------------------------------------------------------
+
+    /**
+     * Allocates every buffer aligned to @param Alignment bytes (or alignof(T), if that is bigger), e.g. custom::alignedVector<float, 64>
+    */
+    template<typename T, size_t Alignment = 64>
+    class alignedAllocator{
+        static_assert(Alignment > 0 && (Alignment & (Alignment - 1)) == 0, "Alignment must be a power of 2");
+    public:
+        using value_type = T;
+        using is_always_equal = std::true_type;
+        static constexpr size_t alignment = Alignment > alignof(T) ? Alignment : alignof(T);
+
+        template<typename U>
+        struct rebind{ using other = alignedAllocator<U, Alignment>; }; //allocator_traits can't rebind a template with a size_t parameter by itself
+
+        alignedAllocator() noexcept = default;
+
+        template<typename U>
+        alignedAllocator(const alignedAllocator<U, Alignment>&) noexcept {}
+
+        [[nodiscard]] T* allocate(size_t count){
+            return static_cast<T*>(::operator new(detail::allocation_bytes<T>(count), std::align_val_t(alignment)));
+        }
+
+        void deallocate(T* p, size_t count) noexcept { ::operator delete(p, count * sizeof(T), std::align_val_t(alignment)); }
+
+        template<typename U>
+        bool operator==(const alignedAllocator<U, Alignment>&) const noexcept { return true; }
+    };
+    //End Aligned Allocator Section ------------------------------------------------------------------
+
+    //Huge Page Allocator Section --------------------------------------------------------------------
+
+    /**
+     * An alignedAllocator whose buffers of 2 MB or more are mapped with mmap instead, rounded up to whole 2 MB pages, aligned to 2 MB,
+     * and marked with madvise(MADV_HUGEPAGE) so the kernel backs them with transparent huge pages.
+     * Whether it does depends on /sys/kernel/mm/transparent_hugepage/enabled being "always" or "madvise". Where there is no mmap, this is just an alignedAllocator.
+     * myVector recognizes it (see huge_pages) and maps trivially relocatable buffers itself, so they grow with mremap rather than by copying
+    */
+    template<typename T, size_t Alignment = 64>
+    class hugePageAllocator{
+        static_assert(Alignment > 0 && (Alignment & (Alignment - 1)) == 0, "Alignment must be a power of 2");
+    public:
+        using value_type = T;
+        using is_always_equal = std::true_type;
+        static constexpr size_t alignment = Alignment > alignof(T) ? Alignment : alignof(T);
+        static constexpr bool huge_pages = true;
+
+        template<typename U>
+        struct rebind{ using other = hugePageAllocator<U, Alignment>; };
+
+        hugePageAllocator() noexcept = default;
+
+        template<typename U>
+        hugePageAllocator(const hugePageAllocator<U, Alignment>&) noexcept {}
+
+        [[nodiscard]] T* allocate(size_t count){
+            const size_t bytes = detail::allocation_bytes<T>(count);
+#if defined(__linux__)
+            if(is_mapped(bytes)){
+                if(bytes > std::numeric_limits<size_t>::max() - 2 * detail::huge_page_size) throw std::bad_array_new_length();
+                const size_t length = detail::align_up(bytes, detail::huge_page_size);
+                //Map an extra huge page, then unmap the bits before and after the first 2 MB boundary, since the kernel only hands out 4 KB alignment
+                void* mapping = mmap(nullptr, length + detail::huge_page_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+                if(mapping == MAP_FAILED) throw std::bad_alloc();
+                std::byte* raw = static_cast<std::byte*>(mapping);
+                std::byte* aligned = reinterpret_cast<std::byte*>(detail::align_up(reinterpret_cast<std::uintptr_t>(raw), detail::huge_page_size));
+                if(aligned != raw) munmap(raw, size_t(aligned - raw));
+                if(aligned + length != raw + length + detail::huge_page_size) munmap(aligned + length, size_t(raw + detail::huge_page_size - aligned));
+#ifdef MADV_HUGEPAGE
+                madvise(aligned, length, MADV_HUGEPAGE); //Only advice: without transparent huge pages the memory still works, just with small pages
+#endif
+                return reinterpret_cast<T*>(aligned);
+            }
+#endif
+            return static_cast<T*>(::operator new(bytes, std::align_val_t(alignment)));
+        }
+
+        void deallocate(T* p, size_t count) noexcept {
+            const size_t bytes = count * sizeof(T);
+#if defined(__linux__)
+            if(is_mapped(bytes)){
+                munmap(p, detail::align_up(bytes, detail::huge_page_size));
+                return;
+            }
+#endif
+            ::operator delete(p, bytes, std::align_val_t(alignment));
+        }
+
+        template<typename U>
+        bool operator==(const hugePageAllocator<U, Alignment>&) const noexcept { return true; }
+
+        /**
+         * Returns true if a buffer of @param bytes is mapped with mmap rather than taken from operator new.
+         * myVector asks this too before it mremaps or munmaps a buffer, so both always agree on where a buffer came from
+        */
+        static constexpr bool is_mapped(size_t bytes) noexcept { return bytes >= detail::huge_page_size && alignment <= detail::huge_page_size; }
+    };
+    //End Huge Page Allocator Section ----------------------------------------------------------------
+}
+#endif //ALLOCATORS
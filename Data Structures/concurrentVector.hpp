@@ -0,0 +1,204 @@
+#ifndef CONCURRENTVEC
+#define CONCURRENTVEC
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+/**
+ * An append-only vector that many threads can push_back to at once, without a lock.
+ *
+ * Objects live in segments that double in size (32, 64, 128, ... objects). A segment is never moved or freed while the vector exists,
+ * so a pointer or reference to an object stays valid for the vector's whole life, unlike myVector, whose realloc moves everything.
+ *
+ * push_back claims a slot by incrementing an atomic counter, installs the slot's segment with a compare-and-swap if no thread has yet,
+ * constructs the object, and then publishes it by setting the slot's ready flag (a release store).
+ * Reading is wait-free: finding an object is a bit of arithmetic and one atomic load of the segment pointer.
+ * A slot counts towards size() as soon as it is claimed, which can be before its object is published, so readers that didn't get the index from
+ * push_back themselves should check is_published (or use get) first.
+ *
+ * Only push_back, emplace_back, reserve and the readers are thread safe. Destroying or clearing the vector has to wait until no thread is using it
+*/
+namespace custom{
+    template<typename T>
+    class concurrentVector{
+    public:
+        using value_type = T;
+        using reference = T&;
+        using const_reference = const T&;
+
+        concurrentVector() noexcept {
+            for(auto& segment : m_segments) segment.store(nullptr, std::memory_order_relaxed);
+        }
+
+        concurrentVector(const concurrentVector&) = delete;
+        concurrentVector& operator=(const concurrentVector&) = delete;
+
+        ~concurrentVector(){ clear(); }
+
+        /**
+         * Appends a copy of @param value and returns its index. Thread safe and lock-free
+        */
+        size_t push_back(const T& value) { return emplace_back(value); }
+        size_t push_back(T&& value) { return emplace_back(std::move(value)); }
+
+        /**
+         * Appends an object constructed from @param args and returns its index. Thread safe and lock-free.
+         * If the constructor throws, the claimed slot is left empty: it still counts towards size(), but is never published
+        */
+        template<typename... Args>
+        size_t emplace_back(Args&&... args) {
+            const size_t index = m_size.fetch_add(1, std::memory_order_relaxed);
+            if(index >= max_size()){
+                m_size.fetch_sub(1, std::memory_order_relaxed);
+                throw std::length_error("concurrentVector is full");
+            }
+            const location at = locate(index);
+            std::byte* segment = segmentFor(at.segment);
+            ::new(static_cast<void*>(objects(segment) + at.offset)) T(std::forward<Args>(args)...);
+            flags(segment, at.segment)[at.offset].store(1, std::memory_order_release); //Everything the constructor wrote becomes visible to any thread that sees the flag
+            return index;
+        }
+
+        /**
+         * Allocates the segments needed to hold @param capacity objects up front, so pushes don't race to allocate them. Thread safe
+        */
+        void reserve(size_t capacity) {
+            if(capacity == 0) return;
+            if(capacity > max_size()) throw std::length_error("concurrentVector cannot hold that many objects");
+            const size_t last = locate(capacity - 1).segment;
+            for(size_t s = 0; s <= last; ++s) segmentFor(s);
+        }
+
+        /**
+         * Returns the object at @param index. Wait-free. The object must be published (e.g. its index came from this thread's push_back,
+         * or is_published returned true)
+        */
+        [[nodiscard]] reference operator[](size_t index) noexcept {
+            const location at = locate(index);
+            return objects(m_segments[at.segment].load(std::memory_order_acquire))[at.offset];
+        }
+
+        [[nodiscard]] const_reference operator[](size_t index) const noexcept {
+            const location at = locate(index);
+            return objects(m_segments[at.segment].load(std::memory_order_acquire))[at.offset];
+        }
+
+        /**
+         * Returns true once the object at @param index is constructed and visible to this thread. Wait-free
+        */
+        [[nodiscard]] bool is_published(size_t index) const noexcept {
+            if(index >= size()) return false;
+            const location at = locate(index);
+            std::byte* segment = m_segments[at.segment].load(std::memory_order_acquire);
+            return segment && flags(segment, at.segment)[at.offset].load(std::memory_order_acquire) != 0;
+        }
+
+        /**
+         * Returns a pointer to the object at @param index, or nullptr if it isn't published yet. Wait-free
+        */
+        [[nodiscard]] T* get(size_t index) noexcept {
+            return is_published(index) ? &(*this)[index] : nullptr;
+        }
+
+        [[nodiscard]] const T* get(size_t index) const noexcept {
+            return is_published(index) ? &(*this)[index] : nullptr;
+        }
+
+        /**
+         * Destroys every object and frees every segment. Not thread safe
+        */
+        void clear() noexcept {
+            const size_t count = std::min(m_size.load(std::memory_order_acquire), max_size());
+            for(size_t s = 0; s < max_segments; ++s){
+                std::byte* segment = m_segments[s].exchange(nullptr, std::memory_order_acquire);
+                if(!segment) continue;
+                const size_t first = (first_segment << s) - first_segment; //Index of the segment's first object
+                const size_t length = segmentLength(s);
+                if constexpr (!std::is_trivially_destructible_v<T>){
+                    for(size_t i = 0; i < length && first + i < count; ++i){
+                        if(flags(segment, s)[i].load(std::memory_order_relaxed)) std::destroy_at(objects(segment) + i);
+                    }
+                }
+                freeSegment(segment, s);
+            }
+            m_size.store(0, std::memory_order_relaxed);
+        }
+
+        /**
+         * Returns the number of claimed slots, published or not
+        */
+        size_t size() const noexcept { return std::min(m_size.load(std::memory_order_acquire), max_size()); }
+        [[nodiscard]] bool isEmpty() const noexcept { return size() == 0; }
+        static constexpr size_t max_size() noexcept { return (first_segment << max_segments) - first_segment; }
+
+    private:
+        static constexpr size_t first_shift = 5;
+        static constexpr size_t first_segment = size_t(1) << first_shift; //Objects in segment 0. Segment s holds first_segment << s
+        static constexpr size_t max_segments = sizeof(size_t) * 8 - first_shift - 1;
+        static constexpr size_t object_align = alignof(T) > alignof(std::atomic<uint8_t>) ? alignof(T) : alignof(std::atomic<uint8_t>);
+
+        struct location{
+            size_t segment;
+            size_t offset;
+        };
+
+        alignas(64) std::atomic<size_t> m_size{0}; //On its own cache line, since every push hits it
+        alignas(64) std::atomic<std::byte*> m_segments[max_segments]; //Read by every push and lookup, so kept off m_size's line
+
+        static size_t segmentLength(size_t segment) noexcept { return first_segment << segment; }
+
+        /**
+         * Object i sits in segment floor(log2(i + 32)) - 5, at i + 32 minus the segment's power of 2
+        */
+        static location locate(size_t index) noexcept {
+            const size_t position = index + first_segment;
+            const size_t high = size_t(std::bit_width(position)) - 1;
+            return {high - first_shift, position - (size_t(1) << high)};
+        }
+
+        //A segment is its objects followed by one ready flag per object
+        static size_t flagsOffset(size_t segment) noexcept {
+            const size_t bytes = segmentLength(segment) * sizeof(T);
+            return (bytes + alignof(std::atomic<uint8_t>) - 1) / alignof(std::atomic<uint8_t>) * alignof(std::atomic<uint8_t>);
+        }
+
+        static size_t segmentBytes(size_t segment) noexcept {
+            return flagsOffset(segment) + segmentLength(segment) * sizeof(std::atomic<uint8_t>);
+        }
+
+        static T* objects(std::byte* segment) noexcept { return std::launder(reinterpret_cast<T*>(segment)); }
+
+        static std::atomic<uint8_t>* flags(std::byte* segment, size_t s) noexcept {
+            return std::launder(reinterpret_cast<std::atomic<uint8_t>*>(segment + flagsOffset(s)));
+        }
+
+        /**
+         * Returns segment @param s, allocating it if no thread has yet. Racing threads each allocate one, and all but the
+         * thread whose compare-and-swap lands free theirs again, so no thread ever waits on another
+        */
+        std::byte* segmentFor(size_t s) {
+            std::byte* segment = m_segments[s].load(std::memory_order_acquire);
+            if(segment) return segment;
+
+            std::byte* fresh = static_cast<std::byte*>(::operator new(segmentBytes(s), std::align_val_t(object_align)));
+            std::atomic<uint8_t>* ready = reinterpret_cast<std::atomic<uint8_t>*>(fresh + flagsOffset(s));
+            for(size_t i = 0; i < segmentLength(s); ++i) ::new(static_cast<void*>(ready + i)) std::atomic<uint8_t>(0);
+
+            if(m_segments[s].compare_exchange_strong(segment, fresh, std::memory_order_acq_rel, std::memory_order_acquire)) return fresh;
+            freeSegment(fresh, s); //Another thread installed the segment first. segment now holds theirs
+            return segment;
+        }
+
+        static void freeSegment(std::byte* segment, size_t s) noexcept {
+            ::operator delete(segment, segmentBytes(s), std::align_val_t(object_align));
+        }
+    };
+}
+#endif //CONCURRENTVEC
@@ -0,0 +1,374 @@
+#ifndef DEVEC
+#define DEVEC
+#include "myVector.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+/**
+ * A double-ended vector: a contiguous buffer with spare capacity at both ends, so push_front and pop_front are amortized O(1) like push_back and pop_back.
+ * myVector's push_front and pop_front shift every object, which makes a myVector used as a queue O(n) per operation.
+ *
+ * The objects are always one contiguous range [data(), data() + size()), so custom::sort, std::span and pointer arithmetic work on them.
+ *
+ * When one end runs out of room and at least half the buffer is free (a queue whose front has been popped), the objects are slid back to the middle
+ * of the buffer instead of reallocating. Otherwise the buffer grows, keeping the gap at the other end no bigger than it was, so a deVector that is only
+ * pushed at the back grows exactly like a myVector. Either way an object is moved O(1) times per insertion on average
+*/
+namespace custom{
+    template<typename T, class Allocator = std::allocator<T>>
+    class deVector{
+    public:
+        using value_type = T;
+        using size_type = size_t;
+        using difference_type = std::ptrdiff_t;
+        using pointer = T*;
+        using const_pointer = const T*;
+        using reference = T&;
+        using const_reference = const T&;
+        using allocator_type = Allocator;
+    private:
+        typedef std::allocator_traits<Allocator> alloc_traits;
+        static_assert(std::is_same_v<typename alloc_traits::value_type, T>, "The allocator's value_type must be T");
+        static_assert(std::is_same_v<typename alloc_traits::pointer, T*>, "Allocators with fancy pointers are not supported");
+        [[no_unique_address]] Allocator allocator;
+        //Same rule as myVector: objects move with memmove if their type allows it and the allocator doesn't hook construct/destroy
+        static constexpr bool relocatable = is_trivially_relocatable_v<T>
+            && !requires(Allocator& a, T* p, T&& v){ a.construct(p, std::move(v)); } && !requires(Allocator& a, T* p){ a.destroy(p); };
+    public:
+        deVector() noexcept(noexcept(Allocator())) : deVector(Allocator()) {}
+
+        explicit deVector(const Allocator& alloc) noexcept : allocator(alloc) {}
+
+        /**
+         * Copy Constructor
+         * The copy's capacity is exactly the size of @param vec, with no spare room at either end
+        */
+        deVector(const deVector& vec) : allocator(alloc_traits::select_on_container_copy_construction(vec.allocator)) {
+            assignRange(vec.m_begin, vec.m_end, vec.size());
+        }
+
+        /**
+         * Move Constructor
+         * Takes over @param moveVec's buffer, leaving it empty
+        */
+        deVector(deVector&& moveVec) noexcept : allocator(moveVec.allocator) {
+            stealBuffer(moveVec);
+        }
+
+        deVector(std::initializer_list<T> il, const Allocator& alloc = Allocator()) : allocator(alloc) {
+            assignRange(il.begin(), il.end(), il.size());
+        }
+
+        template<std::input_iterator InputIt>
+        deVector(InputIt first, InputIt last, const Allocator& alloc = Allocator()) : allocator(alloc) {
+            if constexpr (std::forward_iterator<InputIt>) assignRange(first, last, size_t(std::distance(first, last)));
+            else for(; first != last; ++first) emplace_back(*first);
+        }
+
+        ~deVector(){ releaseBuffer(); }
+
+        deVector& operator=(const deVector& cpy) {
+            if(this == &cpy) return *this;
+            deVector tmp(cpy, alloc_traits::propagate_on_container_copy_assignment::value ? cpy.allocator : allocator);
+            swapBuffers(tmp);
+            if constexpr (alloc_traits::propagate_on_container_copy_assignment::value) std::swap(allocator, tmp.allocator); //tmp frees the old buffer with the allocator that made it
+            return *this;
+        }
+
+        deVector& operator=(deVector&& moveVec) noexcept(alloc_traits::propagate_on_container_move_assignment::value || alloc_traits::is_always_equal::value) {
+            if(this == &moveVec) return *this;
+            if constexpr (alloc_traits::propagate_on_container_move_assignment::value){
+                releaseBuffer();
+                allocator = moveVec.allocator;
+                stealBuffer(moveVec);
+            }
+            else if(alloc_traits::is_always_equal::value || allocator == moveVec.allocator){
+                releaseBuffer();
+                stealBuffer(moveVec);
+            }
+            else{ //The buffer can't change hands, so the objects are moved one by one into memory from our allocator
+                clear();
+                reserve(moveVec.size());
+                for(T& item : moveVec) emplace_back(std::move(item));
+                moveVec.clear();
+            }
+            return *this;
+        }
+
+        /**
+         * Copy Constructor with an allocator, used for copy assignment
+        */
+        deVector(const deVector& vec, const Allocator& alloc) : allocator(alloc) {
+            assignRange(vec.m_begin, vec.m_end, vec.size());
+        }
+
+        [[nodiscard]] bool operator==(const deVector& b) const {
+            return size() == b.size() && std::equal(m_begin, m_end, b.m_begin);
+        }
+
+        /**
+         * Index Operator
+         * Index operator does not provide index safety
+        */
+        [[nodiscard]] reference operator[](size_t index) noexcept { return m_begin[index]; }
+        [[nodiscard]] const_reference operator[](size_t index) const noexcept { return m_begin[index]; }
+
+        /**
+         * Returns the object at @param index, throwing std::out_of_range if index >= size()
+        */
+        [[nodiscard]] reference at(size_t index) {
+            if(index >= size()) throw std::out_of_range("deVector: invalid index");
+            return m_begin[index];
+        }
+
+        [[nodiscard]] const_reference at(size_t index) const {
+            if(index >= size()) throw std::out_of_range("deVector: invalid index");
+            return m_begin[index];
+        }
+
+        void push_back(const_reference data) { emplace_back(data); }
+        void push_back(T&& data) { emplace_back(std::move(data)); }
+        void push_front(const_reference data) { emplace_front(data); }
+        void push_front(T&& data) { emplace_front(std::move(data)); }
+
+        /**
+         * Constructs an object at the back. Amortized O(1)
+        */
+        template<typename... Args>
+        reference emplace_back(Args&&... args) {
+            if(m_end == m_capEnd){ //The arguments may refer to an object in this vector, so build the new object before anything moves
+                T item(std::forward<Args>(args)...);
+                makeRoom(1, false);
+                alloc_traits::construct(allocator, m_end, std::move(item));
+            }
+            else alloc_traits::construct(allocator, m_end, std::forward<Args>(args)...);
+            return *m_end++;
+        }
+
+        /**
+         * Constructs an object at the front. Amortized O(1)
+        */
+        template<typename... Args>
+        reference emplace_front(Args&&... args) {
+            if(m_begin == m_storage){
+                T item(std::forward<Args>(args)...);
+                makeRoom(1, true);
+                alloc_traits::construct(allocator, m_begin - 1, std::move(item));
+            }
+            else alloc_traits::construct(allocator, m_begin - 1, std::forward<Args>(args)...);
+            return *--m_begin;
+        }
+
+        /**
+         * Removes the last object. O(1), does not affect capacity
+        */
+        void pop_back() noexcept {
+            alloc_traits::destroy(allocator, --m_end);
+        }
+
+        /**
+         * Removes the first object. O(1), does not affect capacity: the slot becomes front capacity
+        */
+        void pop_front() noexcept {
+            alloc_traits::destroy(allocator, m_begin++);
+        }
+
+        /**
+         * Makes sure @param capacity objects fit between the front of the objects and the end of the buffer
+        */
+        void reserve(size_t capacity) {
+            if(capacity > size() + back_capacity()) reallocate(capacity - size(), false, capacity - size());
+        }
+
+        /**
+         * Makes sure @param capacity objects fit between the start of the buffer and the back of the objects
+        */
+        void reserve_front(size_t capacity) {
+            if(capacity > size() + front_capacity()) reallocate(capacity - size(), true, capacity - size());
+        }
+
+        /**
+         * Resizes the vector at the back. New objects are value initialized
+        */
+        void resize(size_t newSize) {
+            while(size() > newSize) pop_back();
+            if(newSize > size()){
+                reserve(newSize);
+                while(size() < newSize) emplace_back();
+            }
+        }
+
+        /**
+         * Destroys every object. The capacity is kept, split evenly between the two ends
+        */
+        void clear() noexcept {
+            destroyObjects();
+            m_begin = m_end = m_storage + capacity() / 2;
+        }
+
+        /**
+         * Reallocates so there is no spare room at either end
+        */
+        void shrink_to_fit() {
+            if(front_capacity() == 0 && back_capacity() == 0) return;
+            if(size() == 0){
+                releaseBuffer();
+                return;
+            }
+            deVector tmp(allocator);
+            tmp.allocateEmpty(size(), 0);
+            tmp.relocateFrom(*this);
+            swapBuffers(tmp);
+        }
+
+        void swap(deVector& v) noexcept {
+            if constexpr (alloc_traits::propagate_on_container_swap::value) std::swap(allocator, v.allocator);
+            swapBuffers(v);
+        }
+
+        reference front() noexcept { return *m_begin; }
+        const_reference front() const noexcept { return *m_begin; }
+        reference back() noexcept { return *(m_end - 1); }
+        const_reference back() const noexcept { return *(m_end - 1); }
+
+        pointer data() noexcept { return m_begin; } //The objects are contiguous, so [data(), data() + size()) is a valid range
+        const_pointer data() const noexcept { return m_begin; }
+
+        myIterator<value_type> begin() noexcept { return myIterator<value_type>(m_begin); }
+        myIterator<value_type> end() noexcept { return myIterator<value_type>(m_end); }
+        myIterator<const value_type> begin() const noexcept { return myIterator<const value_type>(m_begin); }
+        myIterator<const value_type> end() const noexcept { return myIterator<const value_type>(m_end); }
+        myIterator<const value_type> cbegin() const noexcept { return begin(); }
+        myIterator<const value_type> cend() const noexcept { return end(); }
+
+        [[nodiscard]] bool isEmpty() const noexcept { return m_begin == m_end; }
+        size_t size() const noexcept { return size_t(m_end - m_begin); }
+        size_t capacity() const noexcept { return size_t(m_capEnd - m_storage); } //Total slots, at both ends and in use
+        size_t front_capacity() const noexcept { return size_t(m_begin - m_storage); } //Free slots before the first object
+        size_t back_capacity() const noexcept { return size_t(m_capEnd - m_end); } //Free slots after the last object
+        allocator_type get_allocator() const noexcept { return allocator; }
+
+    private:
+        pointer m_storage = nullptr; //Start of the buffer
+        pointer m_begin = nullptr; //First object
+        pointer m_end = nullptr; //One past the last object
+        pointer m_capEnd = nullptr; //End of the buffer
+
+        size_t newCapacity() const noexcept { return capacity() * 3 / 2 + 1; } //Same geometric growth as myVector
+
+        void destroyObjects() noexcept {
+            for(pointer p = m_begin; p != m_end; ++p) alloc_traits::destroy(allocator, p);
+        }
+
+        void releaseBuffer() noexcept {
+            destroyObjects();
+            if(m_storage) alloc_traits::deallocate(allocator, m_storage, capacity());
+            m_storage = m_begin = m_end = m_capEnd = nullptr;
+        }
+
+        void stealBuffer(deVector& other) noexcept {
+            m_storage = std::exchange(other.m_storage, nullptr);
+            m_begin = std::exchange(other.m_begin, nullptr);
+            m_end = std::exchange(other.m_end, nullptr);
+            m_capEnd = std::exchange(other.m_capEnd, nullptr);
+        }
+
+        void swapBuffers(deVector& other) noexcept {
+            std::swap(m_storage, other.m_storage);
+            std::swap(m_begin, other.m_begin);
+            std::swap(m_end, other.m_end);
+            std::swap(m_capEnd, other.m_capEnd);
+        }
+
+        /**
+         * Allocates an empty buffer of @param count slots, with the objects to start @param frontGap slots in. Must only be called while empty
+        */
+        void allocateEmpty(size_t count, size_t frontGap) {
+            m_storage = count ? alloc_traits::allocate(allocator, count) : nullptr;
+            m_capEnd = m_storage + count;
+            m_begin = m_end = m_storage + frontGap;
+        }
+
+        template<class Iter>
+        void assignRange(Iter first, Iter last, size_t count) {
+            allocateEmpty(count, 0);
+            try{
+                for(; first != last; ++first) alloc_traits::construct(allocator, m_end++, *first);
+            }
+            catch(...){
+                releaseBuffer();
+                throw;
+            }
+        }
+
+        /**
+         * Moves (or relocates) every object of @param other into this vector's empty buffer at m_begin, leaving other's buffer empty but allocated
+        */
+        void relocateFrom(deVector& other) {
+            if constexpr (relocatable){
+                if(other.size()) std::memcpy(static_cast<void*>(m_begin), static_cast<const void*>(other.m_begin), other.size() * sizeof(T));
+                m_end = m_begin + other.size();
+                other.m_end = other.m_begin;
+            }
+            else{
+                for(pointer p = other.m_begin; p != other.m_end; ++p) alloc_traits::construct(allocator, m_end++, std::move_if_noexcept(*p));
+                other.destroyObjects();
+                other.m_end = other.m_begin;
+            }
+        }
+
+        /**
+         * Makes room for @param count more objects at the front (@param front) or the back.
+         * If at least half the buffer is free the objects are slid back to the middle, otherwise the buffer grows
+        */
+        void makeRoom(size_t count, bool front) {
+            const size_t free = capacity() - size();
+            if(free >= count && free >= capacity() / 2 && capacity() > 1){
+                const size_t gap = (free - count) / 2 + (front ? count : 0); //Centre the objects in what is left once the new ones are in
+                slideTo(m_storage + gap);
+                return;
+            }
+            reallocate(count, front, std::max(count, newCapacity() - size()));
+        }
+
+        /**
+         * Moves the objects within the buffer so they start at @param target
+        */
+        void slideTo(pointer target) {
+            if(target == m_begin) return;
+            if constexpr (relocatable){
+                std::memmove(static_cast<void*>(target), static_cast<const void*>(m_begin), size() * sizeof(T));
+                m_end = target + size();
+                m_begin = target;
+            }
+            else{ //Moving objects that aren't relocatable within one buffer can't be undone halfway, so move them into a fresh buffer of the same size instead
+                deVector tmp(allocator);
+                tmp.allocateEmpty(capacity(), size_t(target - m_storage));
+                tmp.relocateFrom(*this);
+                swapBuffers(tmp);
+            }
+        }
+
+        /**
+         * Grows the buffer by at least @param needed slots at the front (@param front) or the back, adding @param extra free slots on that side in total.
+         * The other side keeps at most the free slots it had, so a vector used from one end only doesn't waste space at the other
+        */
+        void reallocate(size_t needed, bool front, size_t extra) {
+            extra = std::max(extra, needed);
+            const size_t otherGap = front ? back_capacity() : front_capacity();
+            const size_t total = size() + extra + otherGap;
+            deVector tmp(allocator);
+            tmp.allocateEmpty(total, front ? extra : otherGap);
+            tmp.relocateFrom(*this);
+            swapBuffers(tmp);
+        }
+    };
+}
+#endif //DEVEC
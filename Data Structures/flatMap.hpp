@@ -0,0 +1,188 @@
+#ifndef FLATMAP
+#define FLATMAP
+#include "flatSet.hpp"
+#include <stdexcept>
+
+/**
+ * A sorted map stored in a single myVector of key/value entries, with no nodes and no per-entry allocations.
+ * It works the same way as custom::flatSet: binary search lookups over contiguous memory, O(n) single inserts,
+ * and bulk inserts that are sorted with custom::sort and merged in with custom::merge in O(n log n).
+ *
+ * Entries are custom::flatMapEntry, a std::pair whose operator< compares only the keys with Compare. That is what lets custom::sort and custom::merge,
+ * which order by operator<, order the entries. It also means Compare has to be stateless.
+ * Entries behave like std::pair (first, second, structured bindings), but changing the key of an entry in place breaks the map
+*/
+namespace custom{
+    template<typename Key, typename T, class Compare>
+    struct flatMapEntry : std::pair<Key, T>{
+        using std::pair<Key, T>::pair;
+        flatMapEntry() = default;
+        flatMapEntry(const std::pair<Key, T>& p) : std::pair<Key, T>(p) {}
+        flatMapEntry(std::pair<Key, T>&& p) : std::pair<Key, T>(std::move(p)) {}
+
+        friend bool operator<(const flatMapEntry& a, const flatMapEntry& b) { return Compare()(a.first, b.first); }
+    };
+
+    template<typename Key, typename T, class Compare = std::less<Key>, class Allocator = std::allocator<flatMapEntry<Key, T, Compare>>>
+    class flatMap{
+        static_assert(std::is_empty_v<Compare> && std::is_default_constructible_v<Compare>, "flatMap orders its entries with operator<, so Compare has to be stateless");
+    public:
+        using key_type = Key;
+        using mapped_type = T;
+        using value_type = flatMapEntry<Key, T, Compare>;
+        using key_compare = Compare;
+        using allocator_type = Allocator;
+        using size_type = size_t;
+        using iterator = myIterator<value_type>;
+        using const_iterator = myIterator<const value_type>;
+
+        flatMap() = default;
+
+        explicit flatMap(const Allocator& alloc) : m_items(alloc) {}
+
+        /**
+         * Range constructor
+         * Builds the map from the key/value pairs in [first, last) in O(n log n). Of several entries with equivalent keys, one is kept
+        */
+        template<std::input_iterator InputIt>
+        flatMap(InputIt first, InputIt last, const Allocator& alloc = Allocator()) : m_items(alloc) {
+            insert(first, last);
+        }
+
+        flatMap(std::initializer_list<std::pair<Key, T>> il, const Allocator& alloc = Allocator()) : flatMap(il.begin(), il.end(), alloc) {}
+
+        /**
+         * Returns the value for @param key, inserting a value initialized one first if the key isn't in the map
+        */
+        T& operator[](const Key& key) { return try_emplace(key).first->second; }
+
+        /**
+         * Returns the value for @param key, throwing std::out_of_range if the key isn't in the map
+        */
+        T& at(const Key& key) {
+            const size_t index = lowerIndex(key);
+            if(index == m_items.size() || Compare()(key, m_items[index].first)) throw std::out_of_range("flatMap: key not found");
+            return m_items[index].second;
+        }
+
+        const T& at(const Key& key) const {
+            const size_t index = lowerIndex(key);
+            if(index == m_items.size() || Compare()(key, m_items[index].first)) throw std::out_of_range("flatMap: key not found");
+            return m_items[index].second;
+        }
+
+        /**
+         * Inserts @param entry if its key isn't in the map. O(n), since the entries after it have to shift.
+         * Returns the entry's position and whether it was inserted
+        */
+        std::pair<iterator, bool> insert(const std::pair<Key, T>& entry) { return try_emplace(entry.first, entry.second); }
+        std::pair<iterator, bool> insert(std::pair<Key, T>&& entry) { return try_emplace(std::move(entry.first), std::move(entry.second)); }
+
+        /**
+         * Inserts a value constructed from @param args under @param key if the key isn't in the map. Nothing is constructed if it is
+        */
+        template<class K, typename... Args>
+        std::pair<iterator, bool> try_emplace(K&& key, Args&&... args) {
+            const size_t index = lowerIndex(key);
+            if(index != m_items.size() && !Compare()(key, m_items[index].first)) return {begin() + index, false};
+            m_items.emplace(m_items.begin() + index, std::piecewise_construct, std::forward_as_tuple(std::forward<K>(key)), std::forward_as_tuple(std::forward<Args>(args)...));
+            return {begin() + index, true};
+        }
+
+        /**
+         * Sets the value for @param key to @param value, inserting the key if it isn't in the map
+        */
+        template<class V>
+        std::pair<iterator, bool> insert_or_assign(const Key& key, V&& value) {
+            auto [it, inserted] = try_emplace(key, std::forward<V>(value));
+            if(!inserted) it->second = std::forward<V>(value);
+            return {it, inserted};
+        }
+
+        /**
+         * Bulk insert. Appends the pairs in [first, last), sorts them by key and merges them in, so the whole batch costs O((n + m) + m log m).
+         * If several entries in the batch have equivalent keys it is unspecified which one is kept. Keys already in the map keep their values
+        */
+        template<std::input_iterator InputIt>
+        void insert(InputIt first, InputIt last) {
+            const size_t sorted = m_items.size();
+            m_items.insert(m_items.end(), first, last);
+            detail::fold_sorted_tail(m_items, sorted, std::less<>());
+        }
+
+        void insert(std::initializer_list<std::pair<Key, T>> il) { insert(il.begin(), il.end()); }
+
+        /**
+         * Removes the entry for @param key, returning how many entries were removed (0 or 1)
+        */
+        size_t erase(const Key& key) {
+            const size_t index = lowerIndex(key);
+            if(index == m_items.size() || Compare()(key, m_items[index].first)) return 0;
+            m_items.erase(m_items.begin() + index);
+            return 1;
+        }
+
+        /**
+         * Removes the entry at @param it, returning the position of the entry after it
+        */
+        iterator erase(iterator it) {
+            const size_t index = it - begin();
+            m_items.erase(m_items.begin() + index);
+            return begin() + index;
+        }
+
+        /**
+         * Returns the position of the entry for @param key, or end() if there is none
+        */
+        [[nodiscard]] iterator find(const Key& key) {
+            const size_t index = lowerIndex(key);
+            if(index == m_items.size() || Compare()(key, m_items[index].first)) return end();
+            return begin() + index;
+        }
+
+        [[nodiscard]] const_iterator find(const Key& key) const {
+            const size_t index = lowerIndex(key);
+            if(index == m_items.size() || Compare()(key, m_items[index].first)) return cend();
+            return cbegin() + index;
+        }
+
+        [[nodiscard]] bool contains(const Key& key) const { return find(key) != cend(); }
+        [[nodiscard]] size_t count(const Key& key) const { return contains(key) ? 1 : 0; }
+
+        /**
+         * Returns the position of the first entry whose key is not less than @param key
+        */
+        [[nodiscard]] iterator lower_bound(const Key& key) { return begin() + lowerIndex(key); }
+        [[nodiscard]] const_iterator lower_bound(const Key& key) const { return cbegin() + lowerIndex(key); }
+
+        void reserve(size_t capacity) { m_items.reserve(capacity); }
+        void shrink_to_fit() { m_items.shrink_to_fit(); }
+        void clear() noexcept { m_items.clear(); }
+
+        iterator begin() noexcept { return iterator(m_items.data()); }
+        iterator end() noexcept { return iterator(m_items.data() + m_items.size()); }
+        const_iterator begin() const noexcept { return cbegin(); }
+        const_iterator end() const noexcept { return cend(); }
+        const_iterator cbegin() const noexcept { return const_iterator(m_items.data()); }
+        const_iterator cend() const noexcept { return const_iterator(m_items.data() + m_items.size()); }
+
+        [[nodiscard]] bool isEmpty() const noexcept { return m_items.size() == 0; }
+        size_t size() const noexcept { return m_items.size(); }
+        size_t capacity() const noexcept { return m_items.capacity(); }
+        key_compare key_comp() const { return Compare(); }
+        allocator_type get_allocator() const noexcept { return m_items.get_allocator(); }
+
+    private:
+        myVector<value_type, Allocator> m_items;
+
+        /**
+         * Index of the first entry whose key is not less than @param key, found with a branchless binary search
+        */
+        template<class K>
+        size_t lowerIndex(const K& key) const {
+            const value_type* first = m_items.data();
+            return size_t(custom::branchless_lower_bound(first, first + m_items.size(), key, [](const value_type& item, const K& k){ return Compare()(item.first, k); }) - first);
+        }
+    };
+}
+#endif //FLATMAP
@@ -0,0 +1,189 @@
+#ifndef FLATSET
+#define FLATSET
+#include "myVector.hpp"
+#include "../Algorithms/sort.hpp"
+#include "../Algorithms/merge.hpp"
+#include "../Algorithms/search.hpp"
+#include <algorithm>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+/**
+ * A sorted set stored in a single myVector, with no nodes and no per-item allocations.
+ * Lookups are a binary search over contiguous memory, which is much friendlier to the cache than walking the nodes of a std::set.
+ *
+ * Inserting one key has to shift every key after it, so it is O(n). Bulk inserts (the range constructor and insert(first, last)) are buffered instead:
+ * the new keys are appended, sorted with custom::sort, and folded into the existing keys with a single custom::merge, so n inserts cost O(n log n).
+ * Build read-mostly tables in bulk wherever possible.
+ *
+ * Like any vector, inserting and erasing invalidates iterators
+*/
+namespace detail{
+    template<class Compare, class Key>
+    inline constexpr bool natural_order = std::is_same_v<Compare, std::less<Key>> || std::is_same_v<Compare, std::less<>>;
+
+    /**
+     * Sorts the unsorted tail items[sorted, size()) and folds it into the sorted, unique head items[0, sorted), then keeps only the first of
+     * each run of equivalent items. On ties the merge takes the head's item, so items already in the table win over newly inserted ones.
+     * When @param comp is plain operator< the tail is sorted with custom::sort and merged with custom::merge, otherwise the std versions taking comp are used
+    */
+    template<class Vector, class Compare>
+    void fold_sorted_tail(Vector& items, size_t sorted, Compare comp){
+        using V = typename Vector::value_type;
+        constexpr bool natural = natural_order<Compare, V>;
+        if(items.size() == sorted) return;
+
+        V* first = items.data();
+        V* middle = first + sorted;
+        V* last = first + items.size();
+        if constexpr (natural) custom::sort(middle, last);
+        else std::sort(middle, last, comp);
+
+        size_t from = sorted == 0 ? 0 : sorted - 1; //Equivalent items can only meet at the seam, unless the runs have to be merged
+        if(sorted != 0 && comp(*middle, *(middle - 1))){ //The tail doesn't simply go after the head, so merge them into a new buffer in one pass
+            Vector merged(items.get_allocator());
+            merged.reserve(items.size());
+            const auto mergeFirst = std::make_move_iterator(first), mergeMiddle = std::make_move_iterator(middle), mergeLast = std::make_move_iterator(last);
+            if constexpr (natural) custom::merge(mergeFirst, mergeMiddle, mergeMiddle, mergeLast, std::back_inserter(merged));
+            else std::merge(mergeFirst, mergeMiddle, mergeMiddle, mergeLast, std::back_inserter(merged), comp);
+            items.swap(merged);
+            from = 0;
+        }
+
+        V* begin = items.data();
+        V* newEnd = std::unique(begin + from, begin + items.size(), [&comp](const V& kept, const V& next){ return !comp(kept, next); });
+        items.erase(items.begin() + (newEnd - begin), items.end());
+    }
+}
+
+namespace custom{
+    template<typename Key, class Compare = std::less<Key>, class Allocator = std::allocator<Key>>
+    class flatSet{
+    public:
+        using key_type = Key;
+        using value_type = Key;
+        using key_compare = Compare;
+        using allocator_type = Allocator;
+        using size_type = size_t;
+        using iterator = myIterator<const Key>; //Keys can't be changed in place, since that could break the order
+        using const_iterator = iterator;
+
+        flatSet() = default;
+
+        explicit flatSet(const Compare& comp, const Allocator& alloc = Allocator()) : m_items(alloc), m_comp(comp) {}
+
+        /**
+         * Range constructor
+         * Builds the set from [first, last) in O(n log n). Equivalent keys are stored once
+        */
+        template<std::input_iterator InputIt>
+        flatSet(InputIt first, InputIt last, const Compare& comp = Compare(), const Allocator& alloc = Allocator()) : m_items(alloc), m_comp(comp) {
+            insert(first, last);
+        }
+
+        flatSet(std::initializer_list<Key> il, const Compare& comp = Compare(), const Allocator& alloc = Allocator()) : flatSet(il.begin(), il.end(), comp, alloc) {}
+
+        /**
+         * Inserts @param key if no equivalent key is in the set. O(n), since the keys after it have to shift.
+         * Returns the key's position and whether it was inserted
+        */
+        std::pair<iterator, bool> insert(const Key& key) { return insertOne(key); }
+        std::pair<iterator, bool> insert(Key&& key) { return insertOne(std::move(key)); }
+
+        /**
+         * Bulk insert. Appends [first, last), sorts the new keys and merges them in, so the whole batch costs O((n + m) + m log m).
+         * If several keys in the batch are equivalent to each other it is unspecified which one is kept. Keys already in the set are never replaced
+        */
+        template<std::input_iterator InputIt>
+        void insert(InputIt first, InputIt last) {
+            const size_t sorted = m_items.size();
+            m_items.insert(m_items.end(), first, last);
+            detail::fold_sorted_tail(m_items, sorted, m_comp);
+        }
+
+        void insert(std::initializer_list<Key> il) { insert(il.begin(), il.end()); }
+
+        /**
+         * Removes the key equivalent to @param key, returning how many keys were removed (0 or 1)
+        */
+        size_t erase(const Key& key) {
+            const size_t index = lowerIndex(key);
+            if(index == m_items.size() || m_comp(key, m_items[index])) return 0;
+            m_items.erase(m_items.begin() + index);
+            return 1;
+        }
+
+        /**
+         * Removes the key at @param it, returning the position of the key after it
+        */
+        iterator erase(iterator it) {
+            const size_t index = it - begin();
+            m_items.erase(m_items.begin() + index);
+            return begin() + index;
+        }
+
+        /**
+         * Returns the position of the key equivalent to @param key, or end() if there is none
+        */
+        [[nodiscard]] iterator find(const Key& key) const {
+            const size_t index = lowerIndex(key);
+            if(index == m_items.size() || m_comp(key, m_items[index])) return end();
+            return begin() + index;
+        }
+
+        [[nodiscard]] bool contains(const Key& key) const { return find(key) != end(); }
+        [[nodiscard]] size_t count(const Key& key) const { return contains(key) ? 1 : 0; }
+
+        /**
+         * Returns the position of the first key not less than @param key
+        */
+        [[nodiscard]] iterator lower_bound(const Key& key) const { return begin() + lowerIndex(key); }
+
+        /**
+         * Returns the position of the first key greater than @param key
+        */
+        [[nodiscard]] iterator upper_bound(const Key& key) const {
+            const Key* first = m_items.data();
+            return begin() + (custom::branchless_lower_bound(first, first + m_items.size(), key, [this](const Key& item, const Key& k){ return !m_comp(k, item); }) - first);
+        }
+
+        void reserve(size_t capacity) { m_items.reserve(capacity); }
+        void shrink_to_fit() { m_items.shrink_to_fit(); }
+        void clear() noexcept { m_items.clear(); }
+
+        iterator begin() const noexcept { return iterator(m_items.data()); }
+        iterator end() const noexcept { return iterator(m_items.data() + m_items.size()); }
+        const Key* data() const noexcept { return m_items.data(); } //The keys in order, as one contiguous array
+
+        [[nodiscard]] bool isEmpty() const noexcept { return m_items.size() == 0; }
+        size_t size() const noexcept { return m_items.size(); }
+        size_t capacity() const noexcept { return m_items.capacity(); }
+        key_compare key_comp() const { return m_comp; }
+        allocator_type get_allocator() const noexcept { return m_items.get_allocator(); }
+
+    private:
+        myVector<Key, Allocator> m_items;
+        [[no_unique_address]] Compare m_comp;
+
+        /**
+         * Index of the first key not less than @param key, found with a branchless binary search
+        */
+        size_t lowerIndex(const Key& key) const {
+            const Key* first = m_items.data();
+            return size_t(custom::branchless_lower_bound(first, first + m_items.size(), key, m_comp) - first);
+        }
+
+        template<class K>
+        std::pair<iterator, bool> insertOne(K&& key) {
+            const size_t index = lowerIndex(key);
+            if(index != m_items.size() && !m_comp(key, m_items[index])) return {begin() + index, false};
+            m_items.emplace(m_items.begin() + index, std::forward<K>(key));
+            return {begin() + index, true};
+        }
+    };
+}
+#endif //FLATSET
@@ -0,0 +1,347 @@
+#ifndef MAPPEDVEC
+#define MAPPEDVEC
+#include "myIterator.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#if !defined(__unix__) && !defined(__APPLE__)
+#error "custom::mappedVector needs POSIX mmap"
+#endif
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * A vector of plain records whose buffer is a memory mapped file, so arrays can be persisted and reloaded without serializing them.
+ * The file is just the records back to back (no header), so opening a file only maps it: a 20 GB file is usable in microseconds,
+ * and pages are read in by the kernel the first time they are touched.
+ *
+ * While a writable vector is open, the file is grown ahead of the vector (with ftruncate, and mremap on Linux) the same way
+ * myVector grows its capacity. The file is cut back down to exactly size() records when the vector is destroyed.
+ *
+ * The records live in the mapping itself, so custom::sort (and anything else taking iterators or pointers) works on them directly:
+ *     custom::mappedVector<record> index("index.bin");
+ *     custom::sort(index.data(), index.data() + index.size());
+*/
+namespace custom{
+    /**
+     * How a mappedVector opens its file
+     * readWrite: creates the file if needed. Changes are written back to the file, and the vector can grow
+     * readOnly: a zero-copy view. Functions that would change the vector throw std::logic_error, and writing through a reference crashes
+     * copyOnWrite: a zero-copy view that can be changed. Changed pages are private copies and never reach the file.
+     *              Growing past the file's size copies the records into anonymous memory
+    */
+    enum class mapMode{ readWrite, readOnly, copyOnWrite };
+
+    template<typename T>
+    class mappedVector{
+        static_assert(std::is_trivially_copyable_v<T> && std::is_trivially_destructible_v<T>, "mappedVector stores the raw bytes of its objects, so T must be trivially copyable");
+    public:
+        using value_type = T;
+        using reference = T&;
+        using const_reference = const T&;
+        using pointer = T*;
+        using const_pointer = const T*;
+        using size_type = size_t;
+
+        /**
+         * File constructor
+         * Maps the file at @param path with @param mode. The file's size must be a whole number of objects.
+         * Throws std::system_error if the file cannot be opened or mapped
+        */
+        explicit mappedVector(const std::string& path, mapMode mode = mapMode::readWrite) : m_mode(mode) {
+            const int flags = mode == mapMode::readWrite ? O_RDWR | O_CREAT : O_RDONLY;
+            m_fd = ::open(path.c_str(), flags | O_CLOEXEC, 0644);
+            if(m_fd < 0) throwErrno("mappedVector: cannot open " + path);
+
+            try{
+                struct stat info;
+                if(::fstat(m_fd, &info) != 0) throwErrno("mappedVector: cannot stat " + path);
+                const size_t bytes = size_t(info.st_size);
+                if(bytes % sizeof(T) != 0) throw std::runtime_error("mappedVector: " + path + " is not a whole number of objects");
+
+                m_fileCapacity = bytes / sizeof(T);
+                if(m_fileCapacity != 0){
+                    m_buffer = mapFile(m_fileCapacity);
+                    m_capacity = m_fileCapacity;
+                    m_size = m_fileCapacity;
+                }
+            }
+            catch(...){
+                ::close(m_fd);
+                throw;
+            }
+        }
+
+        mappedVector(const mappedVector&) = delete;
+        mappedVector& operator=(const mappedVector&) = delete;
+
+        /**
+         * Move Constructor
+         * Takes over the mapping and the file. @param other is left closed and empty
+        */
+        mappedVector(mappedVector&& other) noexcept
+            : m_mode(other.m_mode), m_fd(std::exchange(other.m_fd, -1)), m_buffer(std::exchange(other.m_buffer, nullptr)),
+              m_size(std::exchange(other.m_size, 0)), m_capacity(std::exchange(other.m_capacity, 0)),
+              m_fileCapacity(std::exchange(other.m_fileCapacity, 0)), m_anonymous(std::exchange(other.m_anonymous, false)) {}
+
+        mappedVector& operator=(mappedVector&& other) noexcept {
+            if(this == &other) return *this;
+            close();
+            m_mode = other.m_mode;
+            m_fd = std::exchange(other.m_fd, -1);
+            m_buffer = std::exchange(other.m_buffer, nullptr);
+            m_size = std::exchange(other.m_size, 0);
+            m_capacity = std::exchange(other.m_capacity, 0);
+            m_fileCapacity = std::exchange(other.m_fileCapacity, 0);
+            m_anonymous = std::exchange(other.m_anonymous, false);
+            return *this;
+        }
+
+        /**
+         * Unmaps the file. A readWrite file is truncated to exactly size() objects
+        */
+        ~mappedVector(){ close(); }
+
+        /**
+         * Index Operator
+         * Index operator does not provide index safety
+        */
+        [[nodiscard]] reference operator[](size_t index) noexcept { return m_buffer[index]; }
+        [[nodiscard]] const_reference operator[](size_t index) const noexcept { return m_buffer[index]; }
+
+        /**
+         * Returns the object at @param index, throwing std::out_of_range if index >= size()
+        */
+        [[nodiscard]] reference at(size_t index) {
+            if(index >= m_size) throw std::out_of_range("mappedVector: invalid index");
+            return m_buffer[index];
+        }
+
+        [[nodiscard]] const_reference at(size_t index) const {
+            if(index >= m_size) throw std::out_of_range("mappedVector: invalid index");
+            return m_buffer[index];
+        }
+
+        /**
+         * Adds a new item to the back of the vector.
+         * If the vector is at full capacity, the file (or mapping) grows
+        */
+        void push_back(const_reference data) { emplace_back(data); }
+
+        template<typename... Args>
+        void emplace_back(Args&&... args) {
+            requireWritable();
+            if(m_size == m_capacity) grow(m_size + 1);
+            ::new(static_cast<void*>(m_buffer + m_size)) T(std::forward<Args>(args)...);
+            ++m_size;
+        }
+
+        /**
+         * Removes the item at the back of the vector. Does not affect capacity
+        */
+        void pop_back() {
+            requireWritable();
+            --m_size;
+        }
+
+        /**
+         * Makes room for @param capacity objects. Cannot reserve less space than is already mapped
+        */
+        void reserve(size_t capacity) {
+            requireWritable();
+            if(capacity > m_capacity) remap(capacity);
+        }
+
+        /**
+         * Resizes the vector. New objects are value initialized
+        */
+        void resize(size_t newSize) {
+            const size_t oldSize = m_size;
+            resize_for_overwrite(newSize);
+            if(newSize > oldSize) std::uninitialized_value_construct(m_buffer + oldSize, m_buffer + newSize);
+        }
+
+        /**
+         * Resizes the vector without initializing the new objects, for when they are about to be overwritten anyway.
+         * Pages the file grew by read as zero until they are written
+        */
+        void resize_for_overwrite(size_t newSize) {
+            requireWritable();
+            if(newSize > m_capacity) grow(newSize);
+            m_size = newSize;
+        }
+
+        /**
+         * Removes every object. Does not affect capacity
+        */
+        void clear() {
+            requireWritable();
+            m_size = 0;
+        }
+
+        /**
+         * Shrinks the mapping (and a readWrite file) to exactly size() objects
+        */
+        void shrink_to_fit() {
+            requireWritable();
+            if(m_size != m_capacity) remap(m_size);
+        }
+
+        /**
+         * Writes changed pages back to the file with msync. With @param wait false the writes are only scheduled (MS_ASYNC).
+         * Does nothing for readOnly and copyOnWrite vectors, whose changes never reach the file.
+         * The file keeps its spare capacity past size() until the vector is destroyed
+        */
+        void flush(bool wait = true) {
+            if(m_mode != mapMode::readWrite || !m_buffer) return;
+            if(::msync(m_buffer, m_capacity * sizeof(T), wait ? MS_SYNC : MS_ASYNC) != 0) throwErrno("mappedVector: msync failed");
+        }
+
+        /**
+         * Passes @param advice (e.g. MADV_SEQUENTIAL, MADV_RANDOM, MADV_WILLNEED) on to madvise for the whole mapping,
+         * so the kernel can read ahead (or not) to match how the records are about to be walked
+        */
+        void advise(int advice) const noexcept {
+            if(m_buffer) ::madvise(static_cast<void*>(m_buffer), m_capacity * sizeof(T), advice);
+        }
+
+        reference front() noexcept { return m_buffer[0]; } //Returns a read/write value for the object at the front of the vector
+        const_reference front() const noexcept { return m_buffer[0]; } //Returns a read-only value for the object at the front of the vector
+        reference back() noexcept { return m_buffer[m_size - 1]; } //Returns a read/write value for the object at the back of the vector
+        const_reference back() const noexcept { return m_buffer[m_size - 1]; } //Returns a read-only value for the object at the back of the vector
+
+        pointer data() noexcept { return m_buffer; } //Returns a pointer to the first object, which is the start of the mapping
+        const_pointer data() const noexcept { return m_buffer; }
+
+        myIterator<value_type> begin() noexcept { return myIterator<value_type>(m_buffer); } //Returns a random-access iterator pointing to the front of the vector
+        myIterator<const value_type> begin() const noexcept { return cbegin(); }
+        myIterator<const value_type> cbegin() const noexcept { return myIterator<const value_type>(m_buffer); } //Returns a const random-access iterator to the first element in the vector
+        myIterator<value_type> end() noexcept { return myIterator<value_type>(m_buffer + m_size); } //Returns a random-access iterator pointing just beyond the vector
+        myIterator<const value_type> end() const noexcept { return cend(); }
+        myIterator<const value_type> cend() const noexcept { return myIterator<const value_type>(m_buffer + m_size); } //Returns a const random-access iterator just beyond the vector
+
+        [[nodiscard]] bool isEmpty() const noexcept { return m_size == 0; }
+        size_t size() const noexcept { return m_size; }
+        size_t capacity() const noexcept { return m_capacity; }
+        mapMode mode() const noexcept { return m_mode; }
+
+    private:
+        mapMode m_mode;
+        int m_fd = -1;
+        pointer m_buffer = nullptr; //Start of the mapping, or nullptr while nothing is mapped
+        size_t m_size = 0;
+        size_t m_capacity = 0; //Objects the mapping holds
+        size_t m_fileCapacity = 0; //Objects the file holds, which the mapping must not run past
+        bool m_anonymous = false; //True once a copyOnWrite vector has grown into anonymous memory
+
+        [[noreturn]] static void throwErrno(const std::string& what) {
+            throw std::system_error(errno, std::generic_category(), what);
+        }
+
+        void requireWritable() const {
+            if(m_mode == mapMode::readOnly) throw std::logic_error("mappedVector: the vector was opened read-only");
+        }
+
+        size_t newCapacity() const noexcept { return m_capacity * 3 / 2 + 1; } //Same geometric growth as myVector
+
+        void grow(size_t required) { remap(std::max(required, newCapacity())); }
+
+        pointer mapFile(size_t count) {
+            const int protection = m_mode == mapMode::readOnly ? PROT_READ : PROT_READ | PROT_WRITE;
+            const int sharing = m_mode == mapMode::readWrite ? MAP_SHARED : MAP_PRIVATE;
+            void* p = ::mmap(nullptr, count * sizeof(T), protection, sharing, m_fd, 0);
+            if(p == MAP_FAILED) throwErrno("mappedVector: mmap failed");
+            return static_cast<pointer>(p);
+        }
+
+        /**
+         * Changes the capacity to @param capacity objects.
+         * A readWrite file is resized first so the mapping never covers bytes past the end of the file (touching those raises SIGBUS).
+         * A copyOnWrite vector cannot grow its file, so the first time it grows the records are copied into anonymous memory
+        */
+        void remap(size_t capacity) {
+            if(capacity > std::numeric_limits<size_t>::max() / sizeof(T)) throw std::bad_array_new_length();
+            const size_t bytes = capacity * sizeof(T);
+
+            if(m_mode == mapMode::copyOnWrite && !m_anonymous && capacity > m_fileCapacity){
+                pointer fresh = nullptr;
+                if(bytes != 0){
+                    void* p = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+                    if(p == MAP_FAILED) throwErrno("mappedVector: mmap failed");
+                    fresh = static_cast<pointer>(p);
+                    if(m_size) std::memcpy(static_cast<void*>(fresh), static_cast<const void*>(m_buffer), m_size * sizeof(T));
+                }
+                unmap();
+                m_buffer = fresh;
+                m_capacity = capacity;
+                m_anonymous = true;
+                return;
+            }
+
+            if(m_mode == mapMode::readWrite && capacity > m_fileCapacity){
+                if(::ftruncate(m_fd, off_t(bytes)) != 0) throwErrno("mappedVector: cannot grow the file");
+                m_fileCapacity = capacity;
+            }
+
+            if(bytes == 0) unmap();
+            else if(!m_buffer){
+                m_buffer = m_anonymous ? mapAnonymous(bytes) : mapFile(capacity);
+            }
+            else{
+#if defined(__linux__)
+                void* p = ::mremap(static_cast<void*>(m_buffer), m_capacity * sizeof(T), bytes, MREMAP_MAYMOVE); //Moves page table entries rather than copying or re-reading records
+                if(p == MAP_FAILED) throwErrno("mappedVector: mremap failed");
+                m_buffer = static_cast<pointer>(p);
+#else
+                pointer fresh = m_anonymous ? mapAnonymous(bytes) : mapFile(capacity);
+                if(m_anonymous) std::memcpy(static_cast<void*>(fresh), static_cast<const void*>(m_buffer), std::min(m_size, capacity) * sizeof(T));
+                unmap();
+                m_buffer = fresh;
+#endif
+            }
+            m_capacity = capacity;
+
+            if(m_mode == mapMode::readWrite && capacity < m_fileCapacity){ //Only after the mapping has shrunk, so no mapped page is past the end of the file
+                if(::ftruncate(m_fd, off_t(bytes)) != 0) throwErrno("mappedVector: cannot shrink the file");
+                m_fileCapacity = capacity;
+            }
+        }
+
+        static pointer mapAnonymous(size_t bytes) {
+            void* p = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if(p == MAP_FAILED) throwErrno("mappedVector: mmap failed");
+            return static_cast<pointer>(p);
+        }
+
+        void unmap() noexcept {
+            if(m_buffer) ::munmap(static_cast<void*>(m_buffer), m_capacity * sizeof(T));
+            m_buffer = nullptr;
+            m_capacity = 0;
+        }
+
+        /**
+         * Unmaps and closes the file, cutting a readWrite file down to exactly size() objects
+        */
+        void close() noexcept {
+            if(m_fd < 0) return;
+            unmap();
+            if(m_mode == mapMode::readWrite && m_fileCapacity != m_size) (void)::ftruncate(m_fd, off_t(m_size * sizeof(T)));
+            ::close(m_fd);
+            m_fd = -1;
+            m_size = 0;
+            m_fileCapacity = 0;
+        }
+    };
+}
+#endif //MAPPEDVEC
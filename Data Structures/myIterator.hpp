@@ -2,38 +2,53 @@
 #define MYITER
 #include <iterator>
 #include <cstddef>
+#include <type_traits>
 
 /**
  * This is a custom iterator designed to work with my custom vector. Can be used as a standalone iterator.
- * Iterators like this one are essentially wrappers around pointers to allow for quick operations, 
+ * Iterators like this one are essentially wrappers around pointers to allow for quick operations,
  * such as incrementing using ++, decrementing using --, and comparing iterators.
+ *
+ * It models std::contiguous_iterator, so std::to_address works on it, and algorithms that check for contiguous memory
+ * (custom::sort's radix sort, custom::find's SIMD scan, std::ranges::copy) treat it exactly like a raw pointer.
+ * Everything is constexpr, and a myIterator<T> converts to a myIterator<const T>
 */
 namespace custom{
     template <typename T>
     class myIterator{
     public:
-        using value_type = T;
+        using value_type = std::remove_cv_t<T>;
         using iterator_category = std::random_access_iterator_tag;
+        using iterator_concept = std::contiguous_iterator_tag;
         using difference_type = std::ptrdiff_t;
         using pointer = T*;
         using reference = T&;
 
-        myIterator(T* p) : ptr(p) {}
-        T& operator*() const { return *ptr; } //Dereference operator
-        T* operator->() { return ptr; }
-        myIterator& operator++() { ptr++; return *this; } //Increment operators
-        myIterator operator++(int) { myIterator tmp = *this; ++(*this); return tmp; }
-        myIterator& operator--() { ptr--; return *this; } //Decrement operators 
-        myIterator operator--(int) { myIterator tmp = *this; --(*this); return tmp; }
-        myIterator& operator+=(const difference_type m) { ptr += m; return *this; }
-        myIterator& operator-=(const difference_type m) { ptr -= m; return *this; }        
+        constexpr myIterator() noexcept = default;
+        constexpr myIterator(T* p) noexcept : ptr(p) {}
+
+        template<typename U> requires std::is_convertible_v<U(*)[], T(*)[]> //Only adds const, never converts between types
+        constexpr myIterator(const myIterator<U>& other) noexcept : ptr(other.ptr) {}
+
+        constexpr T& operator*() const noexcept { return *ptr; } //Dereference operator
+        constexpr T* operator->() const noexcept { return ptr; }
+        constexpr T& operator[](const difference_type m) const noexcept { return ptr[m]; }
+        constexpr myIterator& operator++() noexcept { ptr++; return *this; } //Increment operators
+        constexpr myIterator operator++(int) noexcept { myIterator tmp = *this; ++(*this); return tmp; }
+        constexpr myIterator& operator--() noexcept { ptr--; return *this; } //Decrement operators
+        constexpr myIterator operator--(int) noexcept { myIterator tmp = *this; --(*this); return tmp; }
+        constexpr myIterator& operator+=(const difference_type m) noexcept { ptr += m; return *this; }
+        constexpr myIterator& operator-=(const difference_type m) noexcept { ptr -= m; return *this; }
 
         constexpr myIterator operator-(const difference_type m) const noexcept { return myIterator(ptr - m); }
         constexpr myIterator operator+(const difference_type m) const noexcept { return myIterator(ptr + m); }
-        friend auto operator-(const myIterator& lhs, const myIterator& rhs) { return (lhs.ptr - rhs.ptr); }
-        friend auto operator<=>( const myIterator&, const myIterator& ) = default;
+        friend constexpr myIterator operator+(const difference_type m, const myIterator& it) noexcept { return it + m; }
+        friend constexpr difference_type operator-(const myIterator& lhs, const myIterator& rhs) noexcept { return lhs.ptr - rhs.ptr; }
+        friend constexpr bool operator==(const myIterator&, const myIterator&) noexcept = default;
+        friend constexpr auto operator<=>(const myIterator&, const myIterator&) noexcept = default;
     private:
-        T* ptr;
+        template<typename> friend class myIterator;
+        T* ptr = nullptr;
     };
 }
-#endif //MYITER
\ No newline at end of file
+#endif //MYITER
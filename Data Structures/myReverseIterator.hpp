@@ -2,39 +2,55 @@
 #define MYREVERSEITER
 #include <iterator>
 #include <cstddef>
+#include <type_traits>
 /**
  * This is a custom reverse iterator designed to work with my custom vector. Can be used as a standalone reverse iterator.
- * Iterators like this one are essentially wrappers around pointers to allow for quick operations, 
+ * Iterators like this one are essentially wrappers around pointers to allow for quick operations,
  * such as incrementing using ++, decrementing using --, and comparing iterators.
- * 
+ *
  * Difference between reverse iterator and normal iterator is reverse iterators are designed with moving from end->beginning
+ *
+ * Like std::reverse_iterator, it is built from the pointer one past the object it refers to, so rbegin is made from end and rend from begin.
+ * That way rend never has to point before the first object, which would be undefined (and isn't allowed in constexpr code).
+ * It models std::random_access_iterator. It can't be contiguous, since the objects it walks over are laid out backwards
 */
 namespace custom{
     template <typename T>
     class myReverseIterator{
     public:
-        using value_type = T;
+        using value_type = std::remove_cv_t<T>;
         using iterator_category = std::random_access_iterator_tag;
+        using iterator_concept = std::random_access_iterator_tag;
         using difference_type = std::ptrdiff_t;
         using pointer = T*;
         using reference = T&;
 
-        myReverseIterator(T* p) : ptr(p) {}
-        T& operator*() const { return *ptr; } //Dereference operator
-        T* operator->() { return ptr; }
-        myReverseIterator& operator++() { ptr--; return *this; } //Increment operators. Reverse iterator goes backwards when incremented
-        myReverseIterator operator++(int) { myReverseIterator tmp = *this; --(*this); return tmp; }
-        myReverseIterator& operator--() { ptr++; return *this; } //Decrement operators. Reverse iterator goes forwards when decremented
-        myReverseIterator operator--(int) { myReverseIterator tmp = *this; ++(*this); return tmp; }
-        myReverseIterator& operator+=(const difference_type m) { ptr -= m; return *this; }
-        myReverseIterator& operator-=(const difference_type m) { ptr += m; return *this; }        
+        constexpr myReverseIterator() noexcept = default;
+        constexpr explicit myReverseIterator(T* p) noexcept : ptr(p) {} //@param p points one past the object this iterator refers to
+
+        template<typename U> requires std::is_convertible_v<U(*)[], T(*)[]>
+        constexpr myReverseIterator(const myReverseIterator<U>& other) noexcept : ptr(other.base()) {}
+
+        constexpr T* base() const noexcept { return ptr; } //Returns the pointer one past the object, i.e. where a forward iterator for the same spot would point
+
+        constexpr T& operator*() const noexcept { return *(ptr - 1); } //Dereference operator
+        constexpr T* operator->() const noexcept { return ptr - 1; }
+        constexpr T& operator[](const difference_type m) const noexcept { return *(ptr - 1 - m); }
+        constexpr myReverseIterator& operator++() noexcept { ptr--; return *this; } //Increment operators. Reverse iterator goes backwards when incremented
+        constexpr myReverseIterator operator++(int) noexcept { myReverseIterator tmp = *this; ++(*this); return tmp; }
+        constexpr myReverseIterator& operator--() noexcept { ptr++; return *this; } //Decrement operators. Reverse iterator goes forwards when decremented
+        constexpr myReverseIterator operator--(int) noexcept { myReverseIterator tmp = *this; --(*this); return tmp; }
+        constexpr myReverseIterator& operator+=(const difference_type m) noexcept { ptr -= m; return *this; }
+        constexpr myReverseIterator& operator-=(const difference_type m) noexcept { ptr += m; return *this; }
 
         constexpr myReverseIterator operator-(const difference_type m) const noexcept { return myReverseIterator(ptr + m); }
         constexpr myReverseIterator operator+(const difference_type m) const noexcept { return myReverseIterator(ptr - m); }
-        friend auto operator-(const myReverseIterator& lhs, const myReverseIterator& rhs) { return (lhs.ptr + rhs.ptr); }
-        friend auto operator<=>( const myReverseIterator&, const myReverseIterator& ) = default;
+        friend constexpr myReverseIterator operator+(const difference_type m, const myReverseIterator& it) noexcept { return it + m; }
+        friend constexpr difference_type operator-(const myReverseIterator& lhs, const myReverseIterator& rhs) noexcept { return rhs.ptr - lhs.ptr; }
+        friend constexpr bool operator==(const myReverseIterator& lhs, const myReverseIterator& rhs) noexcept { return lhs.ptr == rhs.ptr; }
+        friend constexpr auto operator<=>(const myReverseIterator& lhs, const myReverseIterator& rhs) noexcept { return rhs.ptr <=> lhs.ptr; } //Further along means a lower address
     private:
-        T* ptr;
+        T* ptr = nullptr;
     };
 }
-#endif //MYITER
\ No newline at end of file
+#endif //MYREVERSEITER
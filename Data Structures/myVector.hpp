@@ -2,8 +2,25 @@
 #define MYVEC
 #include "myIterator.hpp"
 #include "myReverseIterator.hpp"
+#include "allocators.hpp"
+#include "../Algorithms/search.hpp"
 #include <vector> //Only used for comparing my vector to an std::vector
 #include <algorithm>
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <memory_resource>
+#include <ranges>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#if defined(__linux__)
+#define CUSTOM_VECTOR_MREMAP 1
+#include <sys/mman.h>
+#endif
 
 /**
  * This is my custom vector class. This has many of the same functionalities as std::vector. Has support for both standard and custom objects.
@@ -11,52 +28,277 @@
  * std::vector is lacking.
  * 
  * I built this custom vector class to learn some memory management through heap allocation/deallocation and to learn templated classes
+ *
+ * The allocator is a template parameter (std::allocator by default). Copying, moving and swapping follow the allocator's propagate_on_container_* traits,
+ * like the standard containers do. See allocators.hpp for an arena and a pool allocator, and custom::pmr::myVector for std::pmr memory resources
+ *
+ * An inline capacity (custom::smallVector<T, N>) keeps up to N objects inside the vector object itself, and only allocates once it grows past that.
+ * Small vectors never touch the allocator, at the cost of moves and swaps having to move inline objects one at a time
+ *
+ * Trivially relocatable objects (see custom::is_trivially_relocatable) are moved around with memcpy/memmove when the vector grows, shrinks or shifts.
+ * On Linux, big buffers of them (with std::allocator) are mapped directly with mmap, so growing them remaps pages with mremap instead of copying
+ *
+ * custom::alignedVector<T, 64> aligns the buffer to 64 bytes (see allocators.hpp), and custom::hugePageVector<T> also backs buffers of 2 MB or more
+ * with transparent huge pages
+ *
+ * How much a full vector grows by is up to its growth policy (custom::geometricGrowth<3, 2, 1>, i.e. 1.5x + 1, by default).
+ * Defining CUSTOM_VECTOR_STATS (or configuring with -DCUSTOM_VECTOR_STATS=ON) makes every vector count its allocations, reallocations and element moves,
+ * readable per vector with stats() or summed over every vector of a type with type_stats(). Without it the counters compile away to nothing
 */
 namespace custom{
-    template <typename T>
-    class myVector{
+    /**
+     * What myVector's instrumentation counted. Bytes are the object storage handed out by the allocator (or mmap), not counting inline space.
+     * Moves and copies are the objects carried over to a new buffer by growth, or shifted over by inserts and erases.
+     * peak_slack is the largest capacity - size seen right after the buffer changed size or objects were removed
+    */
+    struct vectorStats{
+        size_t reallocations = 0;
+        size_t bytes_allocated = 0;
+        size_t bytes_freed = 0;
+        size_t elements_moved = 0;
+        size_t elements_copied = 0;
+        size_t peak_slack = 0;
+    };
+
+    /**
+     * A myVector growth policy: next_capacity(capacity) returns the capacity a full vector grows to.
+     * myVector always grows by at least one object, whatever the policy returns
+    */
+    template<class Policy>
+    concept growth_policy = requires(size_t capacity){ { Policy::next_capacity(capacity) } -> std::convertible_to<size_t>; };
+
+    /**
+     * Grows the capacity to capacity * Numerator / Denominator + Extra, e.g. geometricGrowth<2, 1, 0> doubles it
+    */
+    template<size_t Numerator = 3, size_t Denominator = 2, size_t Extra = 1>
+    struct geometricGrowth{
+        static_assert(Denominator > 0 && Numerator >= Denominator, "geometricGrowth can't shrink the capacity");
+        static constexpr size_t next_capacity(size_t capacity) noexcept { return capacity * Numerator / Denominator + Extra; }
+    };
+}
+
+namespace detail{
+    /**
+     * Raw, uninitialized space for N objects inside a myVector. Takes no space when N is 0
+    */
+    template<typename T, size_t N>
+    struct inlineStorage{
+        alignas(T) std::byte bytes[N * sizeof(T)];
+
+        inlineStorage() noexcept {} //Leaves the bytes uninitialized on purpose, objects are constructed in them as needed
+        T* data() noexcept { return reinterpret_cast<T*>(bytes); }
+        const T* data() const noexcept { return reinterpret_cast<const T*>(bytes); }
+    };
+
+    template<typename T>
+    struct inlineStorage<T, 0>{
+        T* data() noexcept { return nullptr; }
+        const T* data() const noexcept { return nullptr; }
+    };
+
+#ifdef CUSTOM_VECTOR_STATS
+    inline constexpr bool vector_stats = true;
+#else
+    inline constexpr bool vector_stats = false;
+#endif
+
+    /**
+     * Running totals for every myVector of one object type. Vectors on different threads add to them, so they are relaxed atomics
+    */
+    struct sharedVectorStats{
+        std::atomic<size_t> reallocations{0};
+        std::atomic<size_t> bytes_allocated{0};
+        std::atomic<size_t> bytes_freed{0};
+        std::atomic<size_t> elements_moved{0};
+        std::atomic<size_t> elements_copied{0};
+        std::atomic<size_t> peak_slack{0};
+
+        custom::vectorStats load() const noexcept {
+            constexpr auto relaxed = std::memory_order_relaxed;
+            return {reallocations.load(relaxed), bytes_allocated.load(relaxed), bytes_freed.load(relaxed),
+                    elements_moved.load(relaxed), elements_copied.load(relaxed), peak_slack.load(relaxed)};
+        }
+
+        void reset() noexcept {
+            for(std::atomic<size_t>* counter : {&reallocations, &bytes_allocated, &bytes_freed, &elements_moved, &elements_copied, &peak_slack}){
+                counter->store(0, std::memory_order_relaxed);
+            }
+        }
+    };
+
+    template<typename T>
+    inline sharedVectorStats type_vector_stats; //One set of totals per object type, whatever the allocator, inline capacity or growth policy
+
+    /**
+     * The counters inside a myVector. Each event is added to the vector's own vectorStats and to its type's totals
+    */
+    template<typename T, bool Enabled = vector_stats>
+    struct vectorCounters{
+        custom::vectorStats counts;
+
+        void reallocated() noexcept { ++counts.reallocations; add(type_vector_stats<T>.reallocations, 1); }
+        void allocated(size_t bytes) noexcept { counts.bytes_allocated += bytes; add(type_vector_stats<T>.bytes_allocated, bytes); }
+        void freed(size_t bytes) noexcept { counts.bytes_freed += bytes; add(type_vector_stats<T>.bytes_freed, bytes); }
+        void moved(size_t count) noexcept { counts.elements_moved += count; add(type_vector_stats<T>.elements_moved, count); }
+        void copied(size_t count) noexcept { counts.elements_copied += count; add(type_vector_stats<T>.elements_copied, count); }
+
+        void slack(size_t unused) noexcept {
+            if(unused <= counts.peak_slack) return;
+            counts.peak_slack = unused;
+            std::atomic<size_t>& peak = type_vector_stats<T>.peak_slack;
+            size_t seen = peak.load(std::memory_order_relaxed);
+            while(seen < unused && !peak.compare_exchange_weak(seen, unused, std::memory_order_relaxed)) {}
+        }
+
     private:
+        static void add(std::atomic<size_t>& counter, size_t amount) noexcept { counter.fetch_add(amount, std::memory_order_relaxed); }
+    };
+
+    /**
+     * Instrumentation turned off: every event is an empty inline call, and the member takes no space
+    */
+    template<typename T>
+    struct vectorCounters<T, false>{
+        void reallocated() noexcept {}
+        void allocated(size_t) noexcept {}
+        void freed(size_t) noexcept {}
+        void moved(size_t) noexcept {}
+        void copied(size_t) noexcept {}
+        void slack(size_t) noexcept {}
+    };
+}
+
+namespace custom{
+    /**
+     * Marks types whose objects can be moved to a new address by copying their bytes, after which the old bytes are just forgotten (no destructor runs).
+     * Every trivially copyable type can be. Specialize this for other types that can, e.g. types that only own a pointer to the heap
+    */
+    template<typename T>
+    struct is_trivially_relocatable : std::is_trivially_copyable<T> {};
+
+    template<typename T>
+    struct is_trivially_relocatable<std::unique_ptr<T>> : std::true_type {};
+
+    template<typename T>
+    inline constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<T>::value;
+
+    template <typename T, class Allocator = std::allocator<T>, size_t InlineCapacity = 0, growth_policy GrowthPolicy = geometricGrowth<>>
+    class myVector{
+    public:
         using value_type = T;
         using difference_type = std::ptrdiff_t;
         using pointer = T*;
         using const_pointer = const T*;
         using reference = T&;
         using const_reference = const T&;
-        std::allocator<value_type> allocator; //The allocator for the current object type. Uses generic allocator if type does not have a custom allocator
-        typedef std::allocator_traits<std::allocator<value_type>> alloc_traits; //The allocator traits used to allocate and construct objects
+    private:
+        typedef std::allocator_traits<Allocator> alloc_traits; //The allocator traits used to allocate and construct objects
+        static_assert(std::is_same_v<typename alloc_traits::value_type, T>, "The allocator's value_type must be T");
+        static_assert(std::is_same_v<typename alloc_traits::pointer, T*>, "Allocators with fancy pointers are not supported");
+        [[no_unique_address]] Allocator allocator; //The allocator for the current object type. Takes no space when the allocator is stateless, like std::allocator
+        static constexpr bool nothrow_steal = InlineCapacity == 0 || std::is_nothrow_move_constructible_v<T>; //Taking over another vector's objects can only throw if they are inline
+        //Objects can be moved with memcpy/memmove if their type allows it and the allocator doesn't hook construct/destroy (polymorphic_allocator only hooks them to pass itself on)
+        static constexpr bool relocatable = is_trivially_relocatable_v<T>
+            && ((!requires(Allocator& a, T* p, T&& v){ a.construct(p, std::move(v)); } && !requires(Allocator& a, T* p){ a.destroy(p); })
+                || (std::is_same_v<Allocator, std::pmr::polymorphic_allocator<T>> && !std::uses_allocator_v<T, Allocator>));
+#ifdef CUSTOM_VECTOR_MREMAP
+        //Buffers of at least map_threshold bytes are mmaped by the vector itself, so they can grow with mremap. Only done for std::allocator, whose memory isn't special,
+        //and for allocators that ask for huge pages, whose big buffers are mapped anyway. mremap keeps the MADV_HUGEPAGE advice when it moves a mapping (see remapBuffer for the alignment)
+        static constexpr bool huge_pages = detail::huge_page_allocator<Allocator>;
+        static constexpr bool mappable = relocatable && (std::is_same_v<Allocator, std::allocator<T>> || huge_pages) && alignof(T) <= 4096
+            && (!huge_pages || requires { requires Allocator::alignment <= 4096 && sizeof(T) <= 4096; }); //mremap only keeps page alignment
+        static constexpr size_t map_threshold = size_t(4) << 20; //Huge page allocators decide for themselves, see isMapped
+#else
+        static constexpr bool mappable = false;
+#endif
     public:
+        using allocator_type = Allocator;
+
         /**
          * Default constructor 
          * Creates an empty vector
         */
-        myVector() : m_capacity(0), m_buffer(nullptr), m_finish(nullptr) {}
+        myVector() noexcept(noexcept(Allocator())) : allocator(), m_buffer(m_inline.data()), m_capacity(InlineCapacity), m_finish(m_buffer) {}
+
+        /**
+         * Allocator constructor
+         * Creates an empty vector that will allocate from @param alloc
+        */
+        explicit myVector(const Allocator& alloc) noexcept : allocator(alloc), m_buffer(m_inline.data()), m_capacity(InlineCapacity), m_finish(m_buffer) {}
 
         /**
          * Copy constructor 
-         * Copies the capacity of the passed in vector and constructs each object to ensure it is properly stored
+         * Copies the capacity of the passed in vector and constructs each object to ensure it is properly stored.
+         * The allocator is copied with select_on_container_copy_construction
         */
-        myVector(const myVector& vec) : m_capacity(vec.capacity()), m_buffer(nullptr), m_finish(nullptr) {
-            m_buffer = alloc_traits::allocate(allocator, m_capacity);
-            m_finish = m_buffer;
-            for (int i = 0; i < vec.size(); ++i) {
-                alloc_traits::construct(allocator, m_buffer + i, *(vec.m_buffer + i));
-                ++m_finish;
+        myVector(const myVector& vec) : myVector(vec, alloc_traits::select_on_container_copy_construction(vec.allocator)) {}
+
+        /**
+         * Copy constructor with an allocator
+         * Same as the copy constructor, but the copy allocates from @param alloc
+        */
+        myVector(const myVector& vec, const Allocator& alloc) : allocator(alloc), m_buffer(nullptr), m_capacity(0), m_finish(nullptr) {
+            allocateEmpty(vec.capacity());
+            try{
+                for(pointer it = vec.m_buffer; it != vec.m_finish; ++it){
+                    alloc_traits::construct(allocator, m_finish, *it);
+                    ++m_finish;
+                }
+            }
+            catch(...){ //The destructor won't run for a half built object, so clean up here
+                releaseBuffer();
+                throw;
             }
         }
 
         /**
          * Move constructor
-         * Moves an existing vector into current vector
+         * Moves an existing vector into current vector. The allocator is copied along with the buffer, and the moved from vector is left empty.
+         * Inline objects are moved one at a time
+        */
+        myVector(myVector&& moveVec) noexcept(nothrow_steal) : allocator(moveVec.allocator), m_buffer(m_inline.data()), m_capacity(InlineCapacity), m_finish(m_buffer) {
+            stealBuffer(moveVec);
+        }
+
+        /**
+         * Move constructor with an allocator
+         * Takes over the buffer of @param moveVec if its memory came from an equal allocator. Otherwise the objects are moved one at a time into memory from @param alloc
         */
-        myVector(myVector&& moveVec) noexcept : m_capacity(std::move(moveVec.m_capacity)), 
-                 m_buffer(std::move(moveVec.m_buffer)), m_finish(std::move(moveVec.m_finish)) {}
+        myVector(myVector&& moveVec, const Allocator& alloc) : allocator(alloc), m_buffer(m_inline.data()), m_capacity(InlineCapacity), m_finish(m_buffer) {
+            if(allocator == moveVec.allocator){
+                stealBuffer(moveVec);
+                return;
+            }
+            m_buffer = m_finish = nullptr;
+            allocateEmpty(moveVec.size());
+            try{
+                for(pointer it = moveVec.m_buffer; it != moveVec.m_finish; ++it){
+                    alloc_traits::construct(allocator, m_finish, std::move_if_noexcept(*it));
+                    ++m_finish;
+                }
+            }
+            catch(...){
+                releaseBuffer();
+                throw;
+            }
+        }
 
         /**
          * Capacity constructor 
          * Allocates @param capacity amount of space, and default initializes the vector
         */
-        myVector(const size_t capacity) : m_capacity(capacity), m_buffer(alloc_traits::allocate(allocator, capacity)), m_finish(m_buffer + capacity) {
-            std::uninitialized_fill(begin(), end(), typename std::iterator_traits<myIterator<value_type>>::value_type());
+        myVector(const size_t capacity, const Allocator& alloc = Allocator()) : allocator(alloc), m_buffer(nullptr), m_capacity(0), m_finish(nullptr) {
+            allocateEmpty(capacity);
+            try{
+                for(size_t i = 0; i < capacity; ++i){
+                    alloc_traits::construct(allocator, m_finish);
+                    ++m_finish;
+                }
+            }
+            catch(...){
+                releaseBuffer();
+                throw;
+            }
         }
 
         /**
@@ -64,12 +306,32 @@ namespace custom{
          * Takes in an initializer list and builds a vector with the data.
          * Initializer lists defined as {x, y, z}
         */
-        myVector(std::initializer_list<value_type> il) : m_capacity(il.end() - il.begin()), m_buffer(alloc_traits::allocate(allocator, il.size())), m_finish(m_buffer) {
-            auto it = il.begin();
-            for(int i = 0; i < il.size(); ++i){
-                alloc_traits::construct(allocator, (m_buffer + i), *it);
-                ++it;
-                ++m_finish;
+        myVector(std::initializer_list<value_type> il, const Allocator& alloc = Allocator()) : allocator(alloc), m_buffer(nullptr), m_capacity(0), m_finish(nullptr) {
+            allocateEmpty(il.size());
+            try{
+                for(const_reference item : il){
+                    alloc_traits::construct(allocator, m_finish, item);
+                    ++m_finish;
+                }
+            }
+            catch(...){
+                releaseBuffer();
+                throw;
+            }
+        }
+
+        /**
+         * Iterator Pair Constructor
+         * Builds a vector from the objects in [first, last). Forward iterators are measured first, so the buffer is allocated once
+        */
+        template<std::input_iterator InputIt>
+        myVector(InputIt first, InputIt last, const Allocator& alloc = Allocator()) : allocator(alloc), m_buffer(m_inline.data()), m_capacity(InlineCapacity), m_finish(m_buffer) {
+            try{
+                assign(first, last);
+            }
+            catch(...){
+                releaseBuffer();
+                throw;
             }
         }
 
@@ -78,37 +340,47 @@ namespace custom{
          * Destroys each object by calling its destructor and deallocates all of the used space
         */
         ~myVector(){
-            destroyObjects(m_buffer, m_finish);
-            alloc_traits::deallocate(allocator, m_buffer, m_capacity);
+            releaseBuffer();
         }
 
 
         /**
          * Copy assignment
-         * Copies the contents of the right-hand side vector into the left-hand side vector
-        */
-        myVector& operator=(const myVector& cpy) noexcept {
-            m_capacity = cpy.capacity();
-            m_buffer = alloc_traits::allocate(allocator, m_capacity);
-            m_finish = m_buffer;
-            for (int i = 0; i < cpy.size(); ++i) {
-                alloc_traits::construct(allocator, m_buffer + i, *(cpy.m_buffer + i));
-                ++m_finish;
+         * Copies the contents of the right-hand side vector into the left-hand side vector.
+         * If the allocator propagates on copy assignment and the two allocators differ, the old buffer is freed with the old allocator first
+        */
+        myVector& operator=(const myVector& cpy) {
+            if(this == &cpy) return *this;
+            if constexpr (alloc_traits::propagate_on_container_copy_assignment::value){
+                if(!alloc_traits::is_always_equal::value && allocator != cpy.allocator) releaseBuffer(); //The new allocator can't free the old buffer
+                allocator = cpy.allocator;
             }
+            assignCopies(cpy.m_buffer, cpy.m_finish, cpy.size());
             return *this;
         }
 
         /**
          * Move assignment
          * Checks if the left-hand side vector == right-hand side vector
-         * Moves right-hand side vector into left-hand side vector
+         * Moves right-hand side vector into left-hand side vector.
+         * The buffer is taken over when the allocator propagates or the allocators are equal, otherwise (or when the objects are inline) they are moved one at a time
         */
-        myVector& operator=(myVector&& moveVec) noexcept {
+        myVector& operator=(myVector&& moveVec) noexcept((alloc_traits::propagate_on_container_move_assignment::value || alloc_traits::is_always_equal::value) && nothrow_steal) {
             if(this == &moveVec) return *this; //Moving something into itself doesn't make sense
 
-            m_capacity = std::move(moveVec.m_capacity);
-            m_buffer = std::move(moveVec.m_buffer);
-            m_finish = std::move(moveVec.m_finish);
+            if constexpr (alloc_traits::propagate_on_container_move_assignment::value){
+                releaseBuffer();
+                allocator = std::move(moveVec.allocator);
+                stealBuffer(moveVec);
+            }
+            else if(alloc_traits::is_always_equal::value || allocator == moveVec.allocator){
+                releaseBuffer();
+                stealBuffer(moveVec);
+            }
+            else{ //The buffer belongs to a different allocator, so it has to stay with moveVec
+                assignCopies(std::make_move_iterator(moveVec.m_buffer), std::make_move_iterator(moveVec.m_finish), moveVec.size());
+                moveVec.clear();
+            }
             return *this;
         }
 
@@ -116,19 +388,16 @@ namespace custom{
          * Initializer List assignment
          * Builds a vector from an initializer list 
         */
-        myVector& operator=(std::initializer_list<value_type> il) noexcept {
-            m_capacity = il.end() - il.begin(); //The length of the initializer list
-            m_buffer = alloc_traits::allocate(allocator, m_capacity);
-            m_finish = m_buffer;
-            auto it = il.begin();
-            for(int i = 0; i < il.size(); ++i){
-                alloc_traits::construct(allocator, m_buffer + i, *it);
-                ++it;
-                ++m_finish;
-            }
+        myVector& operator=(std::initializer_list<value_type> il) {
+            assignCopies(il.begin(), il.end(), il.size());
             return *this;
         }
 
+        /**
+         * Returns a copy of the allocator
+        */
+        allocator_type get_allocator() const noexcept { return allocator; }
+
         /**
          * Equal Comparison Operator
          * Compares two custom::myVector objects to test for equality
@@ -218,6 +487,7 @@ namespace custom{
         /**
          * Adds an object to the front of the vector and moves everything else back
          * If vector is at full capacity, more space is allocated
+         * This is O(n). Use custom::deVector (deVector.hpp) when the front is pushed or popped often
         */
         void push_front(const_reference data) {
             if(size() == m_capacity){
@@ -241,17 +511,19 @@ namespace custom{
         */
         void pop_back() noexcept {
             std::destroy_at(--m_finish);
+            countSlack();
         }
 
         /**
          * Removes the first element from the vector and properly destroys the item as needed.
-         * Moves everything forward one index.
+         * Moves everything forward one index, so this is O(n). Use custom::deVector (deVector.hpp) for queues.
          * Does not affect capacity
         */
         void pop_front() noexcept {
             std::destroy_at(m_buffer);
             --m_finish;
             move_backward(begin(), end());
+            countSlack();
         }
 
         /**
@@ -276,6 +548,7 @@ namespace custom{
                 while(m_finish != m_buffer + newSize){
                     std::destroy_at(--m_finish);
                 }
+                countSlack();
             }
             else if(newSize > m_capacity){
                 realloc(newSize);
@@ -284,6 +557,44 @@ namespace custom{
             m_finish = m_buffer + newSize;
         }
 
+        /**
+         * Resizes the vector like resize, but default initializes the new objects instead of value initializing them.
+         * For trivial types (ints, chars, PODs) the new objects are left uninitialized, which skips a pass over memory
+         * when they are about to be overwritten anyway, e.g. by read() or a decompressor. Reading them before writing them is undefined
+        */
+        void resize_for_overwrite(size_t newSize) {
+            if(newSize <= size()){
+                destroyObjects(m_buffer + newSize, m_finish);
+                m_finish = m_buffer + newSize;
+                countSlack();
+                return;
+            }
+            if(newSize > m_capacity) realloc(newSize);
+            std::uninitialized_default_construct(m_finish, m_buffer + newSize);
+            m_finish = m_buffer + newSize;
+        }
+
+        /**
+         * Same as resize_for_overwrite
+        */
+        void resize_default_init(size_t newSize) { resize_for_overwrite(newSize); }
+
+        /**
+         * Resizes the vector to @param count objects without initializing the new ones, then lets @param op fill them in.
+         * op is called as op(data(), count) and returns how many objects are actually valid (at most count); the vector is cut down to that size.
+         * Growing past capacity grows geometrically, so calling this in a loop to append chunks stays amortized O(1) per object, e.g.
+         *     buf.resize_and_overwrite(buf.size() + 65536, [&](char* p, size_t n){ return n - 65536 + read(fd, p + n - 65536, 65536); });
+         * Only available for trivial types, since objects op doesn't write are never constructed
+        */
+        template<class Operation>
+        void resize_and_overwrite(size_t count, Operation op) requires std::is_trivially_default_constructible_v<T> && std::is_trivially_destructible_v<T> {
+            if(count > m_capacity) realloc(std::max(count, newCapacity()));
+            const size_t written = size_t(std::move(op)(m_buffer, count));
+            if(written > count) throw std::length_error("resize_and_overwrite operation wrote more objects than it was given");
+            m_finish = m_buffer + written;
+            countSlack();
+        }
+
         /**
          * Reverses the current vector using a 2 pointer approach
         */
@@ -300,29 +611,34 @@ namespace custom{
         /**
          * Shrinks the vector to have the exact amount of space allocated as needed.
          * If capacity == size, vector is already properly shrunk.
-         * Otherwise, if capacity > size, the vector is reallocated to have capacity == size
+         * Otherwise, if capacity > size, the vector is reallocated to have capacity == size.
+         * With an inline capacity, a heap buffer is given up once the objects fit inline again
         */
         void shrink_to_fit() {
-            if(m_capacity == size()) return; 
+            if(m_capacity == size() || isInline()) return; //Inline space can't shrink
 
-            size_t tmpCapacity = size();
-            pointer newBuffer = alloc_traits::allocate(allocator, tmpCapacity);
-            pointer newFinish = newBuffer;
-            for(int i = 0; i < size(); ++i){
-                alloc_traits::construct(allocator, newBuffer + i, std::move_if_noexcept(*(m_buffer + i)));
-                ++newFinish;
-            }
-            std::swap(m_capacity, tmpCapacity);
-            std::swap(m_buffer, newBuffer);
-            std::swap(m_finish, newFinish);
-            destroyObjects(newBuffer, newFinish);
-            alloc_traits::deallocate(allocator, newBuffer, tmpCapacity);
+            realloc(size(), true);
         }
 
         /**
-         * Swaps two vectors by swapping their capacities and their pointers, rather than swapping all of the data
+         * Swaps two vectors by swapping their capacities and their pointers, rather than swapping all of the data.
+         * The allocators are only swapped if they propagate on swap. Otherwise they must be equal, like with std::vector.
+         * Inline objects can't trade places by swapping pointers, so if either vector is inline the swap goes through a temporary
         */
-        void swap(myVector& v) noexcept{
+        void swap(myVector& v) noexcept(nothrow_steal){
+            if constexpr (InlineCapacity > 0){
+                if(this == &v) return;
+                if(isInline() || v.isInline()){
+                    myVector tmp(std::move(v));
+                    v = std::move(*this);
+                    *this = std::move(tmp);
+                    return;
+                }
+            }
+            if constexpr (alloc_traits::propagate_on_container_swap::value){
+                using std::swap;
+                swap(allocator, v.allocator);
+            }
             std::swap(m_capacity, v.m_capacity);
             std::swap(m_finish, v.m_finish);
             std::swap(m_buffer, v.m_buffer);
@@ -336,6 +652,7 @@ namespace custom{
             while(m_finish > m_buffer){
                 std::destroy_at(--m_finish);
             }
+            countSlack();
         }
 
         /**
@@ -356,6 +673,116 @@ namespace custom{
             ++m_finish;
         }
 
+        /**
+         * Inserts the objects in [first, last) before @param it, and returns an iterator to the first inserted object.
+         * With forward iterators the new size is known up front: the vector reallocates at most once and the objects after it are moved once.
+         * Single pass input iterators are appended one at a time and then rotated into place
+        */
+        template<class Iter, std::input_iterator InputIt>
+        myIterator<value_type> insert(Iter it, InputIt first, InputIt last){
+            const size_t offset = it - begin();
+            if constexpr (multiPass<InputIt>){
+                insertRange(offset, first, last, size_t(std::distance(first, last)));
+            }
+            else{
+                const size_t oldSize = size();
+                for(; first != last; ++first) emplace_back(*first);
+                std::rotate(begin() + offset, begin() + oldSize, end());
+            }
+            return begin() + offset;
+        }
+
+        /**
+         * Inserts @param count copies of @param value before @param it, and returns an iterator to the first inserted object.
+         * Reallocates at most once. The value may be an object in this vector
+        */
+        template<class Iter>
+        myIterator<value_type> insert(Iter it, size_t count, const_reference value){
+            const size_t offset = it - begin();
+            if(count == 0) return begin() + offset;
+            const value_type copy(value); //Shifting the objects could move value out from under us
+            insertRange(offset, repeatIterator{&copy, 0}, repeatIterator{&copy, count}, count);
+            return begin() + offset;
+        }
+
+        /**
+         * Appends every object in @param range. Ranges that can be measured (or walked twice) reallocate at most once
+        */
+        template<std::ranges::input_range Range>
+        void append_range(Range&& range){
+            if constexpr (std::ranges::forward_range<Range> || std::ranges::sized_range<Range>){
+                if constexpr (std::ranges::forward_range<Range>){
+                    insertRange(size(), std::ranges::begin(range), std::ranges::end(range), size_t(std::ranges::distance(range)));
+                    return;
+                }
+                reserve(size() + size_t(std::ranges::size(range)));
+            }
+            for(auto&& item : range) emplace_back(std::forward<decltype(item)>(item));
+        }
+
+        /**
+         * Replaces the contents with the objects in [first, last). Forward iterators are measured first, so the buffer is reallocated at most once
+        */
+        template<std::input_iterator InputIt>
+        void assign(InputIt first, InputIt last){
+            if constexpr (multiPass<InputIt>){
+                assignCopies(first, last, size_t(std::distance(first, last)));
+            }
+            else{
+                clear();
+                for(; first != last; ++first) emplace_back(*first);
+            }
+        }
+
+        /**
+         * Removes the object at @param it, shifting everything after it forward one index.
+         * Returns an iterator to the object that took its place. Does not affect capacity
+        */
+        template<class Iter>
+        myIterator<value_type> erase(Iter it){
+            return erase(it, it + 1);
+        }
+
+        /**
+         * Removes the objects in [first, last), shifting everything after them forward in one pass.
+         * Returns an iterator to the object that took the place of first. Does not affect capacity
+        */
+        template<class Iter>
+        myIterator<value_type> erase(Iter first, Iter last){
+            const size_t offset = first - begin();
+            const size_t count = last - first;
+            if(count == 0) return begin() + offset;
+
+            pointer gap = m_buffer + offset;
+            m_stats.moved(size_t(m_finish - (gap + count)));
+            if constexpr (relocatable){ //Destroy the erased objects, then relocate the tail over them
+                destroyObjects(gap, gap + count);
+                std::memmove(static_cast<void*>(gap), static_cast<const void*>(gap + count), size_t(m_finish - (gap + count)) * sizeof(T));
+            }
+            else{
+                pointer newFinish = std::move(gap + count, m_finish, gap);
+                destroyObjects(newFinish, m_finish);
+            }
+            m_finish -= count;
+            countSlack();
+            return begin() + offset;
+        }
+
+        /**
+         * Removes the object at @param it in O(1) by moving the last object into its place, so the order of the objects is not kept.
+         * Returns an iterator to the object that took its place (end() if the last object was removed)
+        */
+        template<class Iter>
+        myIterator<value_type> unordered_erase(Iter it){
+            pointer hole = m_buffer + (it - begin());
+            if(hole != m_finish - 1){
+                *hole = std::move(*(m_finish - 1));
+                m_stats.moved(1);
+            }
+            pop_back();
+            return myIterator<value_type>(hole);
+        }
+
         /**
          * Emplaces an object at a specified location.
          * Emplace can take an object or object values and construct them in-place.
@@ -389,12 +816,10 @@ namespace custom{
         /**
          * Attemps to find an object based on a value.
          * Returns true if found, otherwise returns false.
+         * Arithmetic types are scanned with SIMD (see search.hpp)
         */
-        bool find(const_reference value_to_find){
-            for(auto it = begin(); it != end(); ++it){
-                if(*it == value_to_find) return true;
-            }
-            return false;
+        bool find(const_reference value_to_find) const {
+            return contains(value_to_find);
         }
 
         /**
@@ -403,10 +828,23 @@ namespace custom{
         */
         template<class Iterator>
         Iterator find(const_reference value_to_find){
-            for(auto it = begin(); it != end(); ++it){
-                if(*it == value_to_find) return it;
-            }
-            return nullptr;
+            const_pointer it = custom::find(static_cast<const_pointer>(m_buffer), static_cast<const_pointer>(m_finish), value_to_find);
+            if(it == m_finish) return nullptr;
+            return Iterator(m_buffer + (it - m_buffer));
+        }
+
+        /**
+         * Returns true if the vector holds an object equal to @param value
+        */
+        [[nodiscard]] bool contains(const_reference value) const {
+            return custom::contains(static_cast<const_pointer>(m_buffer), static_cast<const_pointer>(m_finish), value);
+        }
+
+        /**
+         * Returns the number of objects equal to @param value
+        */
+        [[nodiscard]] size_t count(const_reference value) const {
+            return custom::count(static_cast<const_pointer>(m_buffer), static_cast<const_pointer>(m_finish), value);
         }
 
         reference front() noexcept { return *begin(); } //Returns a read/write value for the object at the front of the vector
@@ -414,36 +852,47 @@ namespace custom{
         reference back() noexcept { return *(end() - 1); } //Returns a read/write value for the object at the back of the vector
         const_reference back() const noexcept { return *(end() - 1); } //Returns a read-only value for the object at the back of the vector
 
+        pointer data() noexcept { return m_buffer; } //Returns a pointer to the first object. The objects are contiguous, so [data(), data() + size()) is a valid range
+        const_pointer data() const noexcept { return m_buffer; } //Returns a read-only pointer to the first object
+
         myIterator<value_type> begin() noexcept { //Returns a random-access iterator pointing to the front of the vector
             return myIterator<value_type>(m_buffer);
         }
 
-        const myIterator<value_type> cbegin() const noexcept{ //Returns a const random-access iterator to the first element in the vector
-            return myIterator<value_type>(m_buffer);
+        myIterator<const value_type> begin() const noexcept { return cbegin(); } //Returns a read-only random-access iterator pointing to the front of the vector
+
+        myIterator<const value_type> cbegin() const noexcept{ //Returns a const random-access iterator to the first element in the vector
+            return myIterator<const value_type>(m_buffer);
         }
 
         myIterator<value_type> end() noexcept { //Returns a random-access iterator pointing just beyond the vector
             return myIterator<value_type>(m_finish);
         }
 
-        const myIterator<value_type> cend() const noexcept { //Returns a const random-access iterator just beyond the vector
-            return myIterator<value_type>(m_finish);
+        myIterator<const value_type> end() const noexcept { return cend(); } //Returns a read-only random-access iterator pointing just beyond the vector
+
+        myIterator<const value_type> cend() const noexcept { //Returns a const random-access iterator just beyond the vector
+            return myIterator<const value_type>(m_finish);
         }
 
         myReverseIterator<value_type> rbegin() noexcept { //Returns a random-access reverse iterator pointing to the last element in the vector
-            return myReverseIterator<value_type>(m_finish - 1);
+            return myReverseIterator<value_type>(m_finish);
         }
 
-        const myReverseIterator<value_type> crbegin() const noexcept { //Returns a const random-access reverse iterator pointing to the last element in the vector
-            return myReverseIterator<value_type>(m_finish - 1);
+        myReverseIterator<const value_type> rbegin() const noexcept { return crbegin(); }
+
+        myReverseIterator<const value_type> crbegin() const noexcept { //Returns a const random-access reverse iterator pointing to the last element in the vector
+            return myReverseIterator<const value_type>(m_finish);
         }
 
         myReverseIterator<value_type> rend() noexcept { //Returns a random-access reverse iterator pointing in front of the vector
-            return myReverseIterator<value_type>(m_buffer - 1);
+            return myReverseIterator<value_type>(m_buffer);
         }
 
-        const myReverseIterator<value_type> crend() const noexcept { //Returns a const random-access reverse iterator pointing in front of the vector
-            return myReverseIterator<value_type>(m_buffer - 1);
+        myReverseIterator<const value_type> rend() const noexcept { return crend(); }
+
+        myReverseIterator<const value_type> crend() const noexcept { //Returns a const random-access reverse iterator pointing in front of the vector
+            return myReverseIterator<const value_type>(m_buffer);
         }
 
         /**
@@ -455,20 +904,55 @@ namespace custom{
         /**
          * Calculates the size of the vector by finding the distance between the end and start of the vector's objects.
         */
-        const size_t size() const noexcept { return size_t(m_finish - m_buffer); }
+        size_t size() const noexcept { return size_t(m_finish - m_buffer); }
 
         /**
          * Returns the capacity of the vector
         */
-        const size_t capacity() const noexcept {return m_capacity; }
+        size_t capacity() const noexcept {return m_capacity; }
+
+        /**
+         * Returns true if the objects are stored inside the vector object rather than in an allocated buffer
+        */
+        [[nodiscard]] bool isInline() const noexcept {
+            if constexpr (InlineCapacity == 0) return false;
+            else return m_buffer == m_inline.data();
+        }
+
+        /**
+         * Returns what this vector's instrumentation has counted since it was constructed or reset_stats was called.
+         * Only available when built with CUSTOM_VECTOR_STATS
+        */
+        const vectorStats& stats() const noexcept requires detail::vector_stats { return m_stats.counts; }
+        void reset_stats() noexcept requires detail::vector_stats { m_stats.counts = vectorStats(); }
+
+        /**
+         * Returns the totals for every myVector of T's, whatever their allocator, inline capacity or growth policy.
+         * peak_slack is the largest slack any one of them had. Only available when built with CUSTOM_VECTOR_STATS
+        */
+        static vectorStats type_stats() noexcept requires detail::vector_stats { return detail::type_vector_stats<T>.load(); }
+        static void reset_type_stats() noexcept requires detail::vector_stats { detail::type_vector_stats<T>.reset(); }
 
     private:
-        pointer m_buffer; //The pointer to where data is stored on the heap
+        [[no_unique_address]] detail::inlineStorage<T, InlineCapacity> m_inline; //Space for the first InlineCapacity objects. Declared first so it exists before m_buffer points at it
+        pointer m_buffer; //The pointer to where data is stored on the heap (or wherever the allocator put it)
         size_t m_capacity; //Actual capacity. Capacity will always be >= size.
 
         pointer m_finish; //A pointer to T bytes past the last item (1 item's worth of space passed the last item)
+        [[no_unique_address]] detail::vectorCounters<T> m_stats; //Counts allocations and moves when built with CUSTOM_VECTOR_STATS, otherwise empty
 
-        const size_t newCapacity() const noexcept { return m_capacity * 3 / 2 + 1; } //Geometric growth so a new allocation doesn't have to be made for every new element
+        //Asks the growth policy how far to grow, so a new allocation doesn't have to be made for every new element
+        size_t newCapacity() const noexcept { return std::max<size_t>(GrowthPolicy::next_capacity(m_capacity), m_capacity + 1); }
+
+        /**
+         * Counts @param count objects carried over to a new buffer with move_if_noexcept, which copies them if moving could throw
+        */
+        void countTransfers(size_t count) noexcept {
+            if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) m_stats.moved(count);
+            else m_stats.copied(count);
+        }
+
+        void countSlack() noexcept { m_stats.slack(m_capacity - size()); }
 
         /**
          * Destroys objects from the starting point to the ending point
@@ -479,16 +963,286 @@ namespace custom{
             std::destroy(start, end);
         }
 
+        /**
+         * True for iterators that can be walked more than once, so a range can be measured before it is copied.
+         * Also accepts iterators that only declare a forward (or better) iterator_category, like myIterator
+        */
+        template<class It>
+        static constexpr bool multiPass = std::forward_iterator<It>
+            || requires { requires std::derived_from<typename std::iterator_traits<It>::iterator_category, std::forward_iterator_tag>; };
+
+        /**
+         * A forward iterator that returns the same object @param count times, so inserting copies of a value can use insertRange
+        */
+        struct repeatIterator{
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = T;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const T*;
+            using reference = const T&;
+
+            const T* value;
+            size_t index;
+
+            reference operator*() const noexcept { return *value; }
+            repeatIterator& operator++() noexcept { ++index; return *this; }
+            repeatIterator operator++(int) noexcept { repeatIterator tmp = *this; ++index; return tmp; }
+            bool operator==(const repeatIterator& other) const noexcept { return index == other.index; }
+        };
+
+        /**
+         * Inserts the @param count objects in [first, last) at @param offset.
+         * If they don't fit, a new buffer is built from the front objects, the new objects and the back objects, each moved or constructed once.
+         * If they fit, the back objects are shifted out of the way once: relocatable objects with one memmove, others by the usual
+         * move-construct into the unused space, move_backward, and assign over the moved from objects
+        */
+        template<class It, class Sentinel>
+        void insertRange(size_t offset, It first, Sentinel last, size_t count){
+            if(count == 0) return;
+            const size_t oldSize = size();
+            const size_t tail = oldSize - offset;
+            if(count > m_capacity - oldSize){
+                size_t newCap = std::max(oldSize + count, newCapacity());
+                m_stats.reallocated();
+                if(!(relocatable && m_buffer != m_inline.data() && isMapped(m_capacity) && isMapped(newCap))){ //A mapped buffer is remapped below instead
+                    pointer newBuffer = allocateBuffer(newCap);
+                    pointer gap = newBuffer + offset;
+                    pointer built = gap;
+                    try{
+                        for(; first != last; ++first, ++built) alloc_traits::construct(allocator, built, *first);
+                        if constexpr (relocatable){
+                            if(offset > 0) std::memcpy(static_cast<void*>(newBuffer), static_cast<const void*>(m_buffer), offset * sizeof(T));
+                            if(tail > 0) std::memcpy(static_cast<void*>(gap + count), static_cast<const void*>(m_buffer + offset), tail * sizeof(T));
+                            m_stats.moved(oldSize);
+                        }
+                        else{
+                            pointer front = newBuffer;
+                            try{
+                                for(pointer it = m_buffer; it != m_buffer + offset; ++it, ++front) alloc_traits::construct(allocator, front, std::move_if_noexcept(*it));
+                                for(pointer it = m_buffer + offset; it != m_finish; ++it, ++built) alloc_traits::construct(allocator, built, std::move_if_noexcept(*it));
+                            }
+                            catch(...){
+                                destroyObjects(newBuffer, front);
+                                throw;
+                            }
+                            destroyObjects(m_buffer, m_finish);
+                            countTransfers(oldSize);
+                        }
+                    }
+                    catch(...){
+                        destroyObjects(gap, built);
+                        deallocateBuffer(newBuffer, newCap);
+                        throw;
+                    }
+                    deallocateBuffer(m_buffer, m_capacity);
+                    m_buffer = newBuffer;
+                    m_finish = newBuffer + oldSize + count;
+                    m_capacity = newCap;
+                    countSlack();
+                    return;
+                }
+                relocate(newCap);
+            }
+
+            pointer pos = m_buffer + offset;
+            m_stats.moved(tail);
+            if constexpr (relocatable){
+                if(tail > 0) std::memmove(static_cast<void*>(pos + count), static_cast<const void*>(pos), tail * sizeof(T));
+                pointer built = pos;
+                try{
+                    for(; first != last; ++first, ++built) alloc_traits::construct(allocator, built, *first);
+                }
+                catch(...){ //Close the gap again so the vector is left as it was
+                    destroyObjects(pos, built);
+                    if(tail > 0) std::memmove(static_cast<void*>(pos), static_cast<const void*>(pos + count), tail * sizeof(T));
+                    throw;
+                }
+                m_finish += count;
+            }
+            else if(tail > count){ //The last count objects move into unused space, the rest of the tail shifts within the vector
+                pointer oldFinish = m_finish;
+                for(pointer it = oldFinish - count; it != oldFinish; ++it){
+                    alloc_traits::construct(allocator, m_finish, std::move(*it));
+                    ++m_finish;
+                }
+                std::move_backward(pos, oldFinish - count, oldFinish);
+                for(; first != last; ++first, ++pos) *pos = *first;
+            }
+            else{ //The whole tail moves into unused space, along with the new objects that land past the old end
+                pointer oldFinish = m_finish;
+                It mid = std::ranges::next(first, std::iter_difference_t<It>(tail));
+                for(It it = mid; it != last; ++it){
+                    alloc_traits::construct(allocator, m_finish, *it);
+                    ++m_finish;
+                }
+                for(pointer it = pos; it != oldFinish; ++it){
+                    alloc_traits::construct(allocator, m_finish, std::move(*it));
+                    ++m_finish;
+                }
+                for(; first != mid; ++first, ++pos) *pos = *first;
+            }
+            countSlack();
+        }
+
+        /**
+         * Allocates space for at least @param count objects, and sets count to the space actually handed out.
+         * Counts that fit get the inline space, and an empty buffer is left as nullptr rather than asking the allocator for 0 objects
+        */
+        pointer allocateBuffer(size_t& count){
+            if(count <= InlineCapacity){
+                count = InlineCapacity;
+                return m_inline.data();
+            }
+#ifdef CUSTOM_VECTOR_MREMAP
+            if(isMapped(count)){
+                if(count > std::numeric_limits<size_t>::max() / sizeof(T)) throw std::bad_array_new_length();
+                if constexpr (huge_pages){ //The allocator maps it 2 MB aligned and asks for huge pages
+                    count = wholeHugePages(count);
+                    pointer buffer = alloc_traits::allocate(allocator, count);
+                    m_stats.allocated(count * sizeof(T));
+                    return buffer;
+                }
+                void* buffer = mmap(nullptr, count * sizeof(T), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+                if(buffer == MAP_FAILED) throw std::bad_alloc();
+                m_stats.allocated(count * sizeof(T));
+                return static_cast<pointer>(buffer);
+            }
+#endif
+            pointer buffer = alloc_traits::allocate(allocator, count);
+            m_stats.allocated(count * sizeof(T));
+            return buffer;
+        }
+
+        /**
+         * Gives a buffer from allocateBuffer back to the allocator. The inline space and nullptr are skipped
+        */
+        void deallocateBuffer(pointer buffer, size_t count) noexcept {
+            if(!buffer || buffer == m_inline.data()) return;
+            m_stats.freed(count * sizeof(T));
+#ifdef CUSTOM_VECTOR_MREMAP
+            if(isMapped(count)){
+                munmap(buffer, count * sizeof(T));
+                return;
+            }
+#endif
+            alloc_traits::deallocate(allocator, buffer, count);
+        }
+
+        /**
+         * Returns true if a (non-inline) buffer of @param count objects is mapped with mmap instead of coming from the allocator.
+         * It only depends on the capacity, so the buffer doesn't have to remember where it came from.
+         * The decision is made on bytes, and for huge page allocators by the allocator itself, since it maps the buffer and the vector unmaps it
+        */
+        static constexpr bool isMapped(size_t count) noexcept {
+            if constexpr (mappable){
+                if(count > std::numeric_limits<size_t>::max() / sizeof(T)) return true; //Too big for any buffer, the mapped path throws bad_array_new_length
+                if constexpr (huge_pages) return Allocator::is_mapped(count * sizeof(T));
+                else return count * sizeof(T) >= map_threshold;
+            }
+            else return false;
+        }
+
+        /**
+         * Rounds @param count up to fill whole 2 MB pages, since the rest of the last huge page is mapped anyway.
+         * Objects are at most 4 KB, so the length of count objects rounded up to the page size is the whole mapping, and munmap or mremap never leave a piece behind
+        */
+        static constexpr size_t wholeHugePages(size_t count) noexcept {
+            return detail::align_up(count * sizeof(T), detail::huge_page_size) / sizeof(T);
+        }
+
+#ifdef CUSTOM_VECTOR_MREMAP
+        /**
+         * Resizes the mapped buffer to @param capacity objects with mremap, which moves the pages instead of copying them. Returns MAP_FAILED if it can't.
+         * MREMAP_MAYMOVE alone may move a huge page buffer to an address that is only 4 KB aligned, so those are grown in place if the address space after them is free,
+         * and otherwise moved with MREMAP_FIXED into a fresh 2 MB aligned mapping from the allocator, which the move replaces
+        */
+        void* remapBuffer(size_t capacity) noexcept {
+            const size_t oldBytes = m_capacity * sizeof(T), newBytes = capacity * sizeof(T);
+            if constexpr (huge_pages){
+                void* buffer = mremap(m_buffer, oldBytes, newBytes, 0); //Shrinking always stays in place
+                if(buffer != MAP_FAILED) return buffer;
+                pointer target;
+                try{ target = alloc_traits::allocate(allocator, capacity); }
+                catch(...){ return MAP_FAILED; }
+                buffer = mremap(m_buffer, oldBytes, newBytes, MREMAP_MAYMOVE | MREMAP_FIXED, static_cast<void*>(target));
+                if(buffer == MAP_FAILED) alloc_traits::deallocate(allocator, target, capacity);
+                return buffer;
+            }
+            else return mremap(m_buffer, oldBytes, newBytes, MREMAP_MAYMOVE);
+        }
+#endif
+
+        /**
+         * Gives a vector that doesn't own a buffer an empty one with space for @param count objects
+        */
+        void allocateEmpty(size_t count){
+            m_buffer = m_finish = allocateBuffer(count);
+            m_capacity = count;
+        }
+
+        /**
+         * Destroys every object and gives the buffer back to the allocator, leaving an empty vector with only the inline capacity
+        */
+        void releaseBuffer() noexcept {
+            destroyObjects(m_buffer, m_finish);
+            deallocateBuffer(m_buffer, m_capacity);
+            m_buffer = m_finish = m_inline.data();
+            m_capacity = InlineCapacity;
+        }
+
+        /**
+         * Takes over the objects of @param other, leaving it empty. This vector must be empty and own no buffer (e.g. right after releaseBuffer),
+         * and the caller makes sure the buffer was allocated by an allocator equal to this one.
+         * A heap buffer changes owners by swapping pointers. Inline objects have to be moved into this vector's own inline space
+        */
+        void stealBuffer(myVector& other) noexcept(nothrow_steal) {
+            if(other.isInline()){
+                for(pointer it = other.m_buffer; it != other.m_finish; ++it){
+                    alloc_traits::construct(allocator, m_finish, std::move(*it));
+                    ++m_finish;
+                }
+                m_stats.moved(size());
+                other.clear();
+                return;
+            }
+            m_buffer = std::exchange(other.m_buffer, other.m_inline.data());
+            m_finish = std::exchange(other.m_finish, other.m_inline.data());
+            m_capacity = std::exchange(other.m_capacity, InlineCapacity);
+        }
+
+        /**
+         * Replaces the contents with the @param count objects in [first, last), constructing them from *first.
+         * The buffer is only reallocated if it is too small
+        */
+        template<class Iter>
+        void assignCopies(Iter first, Iter last, size_t count){
+            clear();
+            if(count > m_capacity){
+                releaseBuffer();
+                allocateEmpty(count);
+            }
+            for(; first != last; ++first){
+                alloc_traits::construct(allocator, m_finish, *first);
+                ++m_finish;
+            }
+        }
+
         /**
          * Reallocates space when the vector's capacity is full and the user tries to add more objects.
-         * Also used when reserve is called
+         * Also used when reserve is called, and by shrink_to_fit with @param exact set so a capacity of 0 frees the buffer
         */
-        void realloc(size_t capacity = 0){
-            pointer newFinish, newBuffer;
-            size_t tmpCapacity;
+        void realloc(size_t capacity = 0, bool exact = false){
+            m_stats.reallocated();
+            if constexpr (relocatable){
+                relocate(capacity == 0 && !exact ? newCapacity() : capacity);
+                countSlack();
+                return;
+            }
+            pointer newFinish = nullptr, newBuffer = nullptr;
+            size_t tmpCapacity = 0;
             try{
-                tmpCapacity = capacity == 0 ? newCapacity() : capacity; //If capacity is 0 (default), get the new capacity value
-                newBuffer = alloc_traits::allocate(allocator, tmpCapacity); //Uses the current type's allocator to allocate the proper amount of space.
+                tmpCapacity = capacity == 0 && !exact ? newCapacity() : capacity; //If capacity is 0 (default), get the new capacity value
+                newBuffer = allocateBuffer(tmpCapacity); //Uses the current type's allocator to allocate the proper amount of space.
                 newFinish = newBuffer; //Temporarily sets the new finish to the start of the vector
                 for(size_t i = 0; i < size(); ++i){
                     alloc_traits::construct(allocator, newBuffer + i, std::move_if_noexcept(*(m_buffer + i))); //Properly adds elements to the new vector
@@ -499,34 +1253,126 @@ namespace custom{
                 std::swap(m_finish, newFinish);
 
                 destroyObjects(newBuffer, newFinish); //Destroy the old vector after the new vector has been swapped
-                alloc_traits::deallocate(allocator, newBuffer, tmpCapacity); //Free the old space
+                deallocateBuffer(newBuffer, tmpCapacity); //Free the old space
+                countTransfers(size());
+                countSlack();
             }
             catch(...){ //If something went wrong while allocating more space, deallocate the newly created space and throw the exception.
                 destroyObjects(newBuffer, newFinish);
-                alloc_traits::deallocate(allocator, newBuffer, tmpCapacity);
+                deallocateBuffer(newBuffer, tmpCapacity);
                 throw;
             }
         }
+        /**
+         * realloc for trivially relocatable objects. They are copied over with one memcpy, and the old copies are forgotten rather than destroyed.
+         * When both the old and the new buffer are mapped, mremap moves the pages to the new size instead, without copying anything
+        */
+        void relocate(size_t capacity){
+            const size_t count = size();
+#ifdef CUSTOM_VECTOR_MREMAP
+            if(m_buffer != m_inline.data() && isMapped(m_capacity) && isMapped(capacity)){
+                if(capacity > std::numeric_limits<size_t>::max() / sizeof(T)) throw std::bad_array_new_length();
+                if constexpr (huge_pages) capacity = wholeHugePages(capacity);
+                void* buffer = remapBuffer(capacity);
+                if(buffer == MAP_FAILED) throw std::bad_alloc();
+                m_stats.freed(m_capacity * sizeof(T)); //Counted as a new mapping replacing the old one, though the pages themselves aren't copied
+                m_stats.allocated(capacity * sizeof(T));
+                m_buffer = static_cast<pointer>(buffer);
+                m_finish = m_buffer + count;
+                m_capacity = capacity;
+                return;
+            }
+#endif
+            pointer newBuffer = allocateBuffer(capacity);
+            if(count > 0) std::memcpy(static_cast<void*>(newBuffer), static_cast<const void*>(m_buffer), count * sizeof(T));
+            m_stats.moved(count);
+            deallocateBuffer(m_buffer, m_capacity);
+            m_buffer = newBuffer;
+            m_finish = newBuffer + count;
+            m_capacity = capacity;
+        }
+
+        /**
+         * Shifts [start, end) one place towards the back. The slot at end must be allocated but empty,
+         * and the slot at start is left empty for the caller to construct into
+        */
         template<class Iter>
-        void move_forward(Iter start, Iter end) noexcept {
+        void move_forward(Iter start, Iter end) {
             
             if(start == end) return;
+            m_stats.moved(size_t(end - start));
 
-            while(end != start){
-                *end = *(end - 1);
-                --end;
+            if constexpr (relocatable){ //Shifting relocatable objects is a relocation, so a single memmove does it
+                std::memmove(static_cast<void*>(&*start + 1), static_cast<const void*>(&*start), size_t(end - start) * sizeof(T));
+            }
+            else{ //The slot at end holds no object yet, so the last object is move constructed into it rather than assigned
+                pointer first = &*start, last = &*end;
+                alloc_traits::construct(allocator, last, std::move(*(last - 1)));
+                std::move_backward(first, last - 1, last);
+                alloc_traits::destroy(allocator, first);
             }
         }
+        /**
+         * Shifts (start, end] one place towards the front, into the slot at start. The slot at start must be empty (its object already destroyed),
+         * and the slot at end is left empty
+        */
         template<class Iter>
-        void move_backward(Iter start, Iter end) noexcept {
+        void move_backward(Iter start, Iter end) {
 
             if(start == end) return;
+            m_stats.moved(size_t(end - start));
 
-            while(start != end){
-                *start = *(start + 1);
-                ++start;
+            if constexpr (relocatable){
+                std::memmove(static_cast<void*>(&*start), static_cast<const void*>(&*start + 1), size_t(end - start) * sizeof(T));
+            }
+            else{
+                pointer first = &*start, last = &*end;
+                alloc_traits::construct(allocator, first, std::move(*(first + 1)));
+                std::move(first + 2, last + 1, first + 1);
+                alloc_traits::destroy(allocator, last);
             }
         }
     };
+
+    /**
+     * Removes every object in @param vec that @param pred returns true for, keeping the order of the rest.
+     * Kept objects are compacted forward in a single linear pass, so removing many objects costs O(n) rather than O(n) per object.
+     * Returns the number of objects removed
+    */
+    template<typename T, class Allocator, size_t InlineCapacity, class GrowthPolicy, class Predicate>
+    size_t erase_if(myVector<T, Allocator, InlineCapacity, GrowthPolicy>& vec, Predicate pred){
+        const auto last = vec.end();
+        const auto newEnd = std::remove_if(vec.begin(), last, pred);
+        const size_t removed = size_t(last - newEnd);
+        vec.erase(newEnd, last);
+        return removed;
+    }
+
+    /**
+     * A myVector that stores up to N objects inline before it allocates, e.g. custom::smallVector<int, 16>
+    */
+    template<typename T, size_t N, class Allocator = std::allocator<T>>
+    using smallVector = myVector<T, Allocator, N>;
+
+    /**
+     * A myVector whose buffer starts on an @param Alignment byte boundary, e.g. custom::alignedVector<float, 64> for SIMD loops
+    */
+    template<typename T, size_t Alignment = 64>
+    using alignedVector = myVector<T, alignedAllocator<T, Alignment>>;
+
+    /**
+     * A myVector whose buffers of 2 MB or more are mapped with mmap and backed by transparent huge pages, for vectors of many gigabytes
+     * that are sorted or scanned end to end. Smaller buffers are just aligned to @param Alignment bytes
+    */
+    template<typename T, size_t Alignment = 64>
+    using hugePageVector = myVector<T, hugePageAllocator<T, Alignment>>;
+
+    namespace pmr{
+        /**
+         * A myVector that allocates from a std::pmr::memory_resource, e.g. custom::pmr::myVector<int> v(&resource) with a std::pmr::monotonic_buffer_resource
+        */
+        template<typename T>
+        using myVector = custom::myVector<T, std::pmr::polymorphic_allocator<T>>;
+    }
 }
 #endif //MYVEC
\ No newline at end of file
@@ -0,0 +1,204 @@
+#ifndef SOAVEC
+#define SOAVEC
+#include "myVector.hpp"
+#include "../Algorithms/sort.hpp"
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+/**
+ * A structure-of-arrays vector. Each field of a row is stored in its own myVector column, so a loop that only reads two fields of a wide record
+ * only pulls those two columns through the cache, instead of every field of every record.
+ *
+ *     custom::soaVector<int, double, std::string> table;
+ *     table.push_back(3, 1.5, "c");
+ *     std::span<double> prices = table.column<1>();
+ *     table.sort_by<0>();
+ *
+ * Rows are added and removed as a whole, so every column always has size() objects
+*/
+namespace detail{
+    /**
+     * A sort key paired with the row it came from. Ties are broken by row, so sorting these is stable
+    */
+    template<typename Key>
+    struct keyedRow{
+        Key key;
+        size_t row;
+        friend bool operator<(const keyedRow& a, const keyedRow& b) { return a.key < b.key || (!(b.key < a.key) && a.row < b.row); }
+    };
+}
+
+namespace custom{
+    template<typename... Fields>
+    class soaVector{
+        static_assert(sizeof...(Fields) > 0, "soaVector needs at least one field");
+    public:
+        using row_type = std::tuple<Fields...>;
+        template<size_t Column>
+        using column_type = std::tuple_element_t<Column, row_type>;
+        static constexpr size_t columns = sizeof...(Fields);
+
+        soaVector() = default;
+
+        /**
+         * Adds a row to the back, one value per field
+        */
+        void push_back(const Fields&... values) { emplace_back(values...); }
+
+        void push_back(const row_type& row) {
+            std::apply([this](const Fields&... values){ emplace_back(values...); }, row);
+        }
+
+        /**
+         * Adds a row to the back, constructing each field from the matching argument.
+         * If any field throws, the fields already added are removed again, so the columns never differ in size
+        */
+        template<typename... Args>
+        void emplace_back(Args&&... args) {
+            static_assert(sizeof...(Args) == columns, "emplace_back takes one argument per column");
+            size_t added = 0;
+            try{
+                emplaceColumns(std::index_sequence_for<Fields...>(), added, std::forward<Args>(args)...);
+            }
+            catch(...){
+                popColumns(std::index_sequence_for<Fields...>(), added);
+                throw;
+            }
+        }
+
+        /**
+         * Removes the last row
+        */
+        void pop_back() noexcept {
+            std::apply([](auto&... column){ (column.pop_back(), ...); }, m_columns);
+        }
+
+        /**
+         * Returns the fields of row @param index as a tuple of references
+        */
+        std::tuple<Fields&...> row(size_t index) noexcept {
+            return std::apply([index](auto&... column){ return std::tuple<Fields&...>(column[index]...); }, m_columns);
+        }
+
+        std::tuple<const Fields&...> row(size_t index) const noexcept {
+            return std::apply([index](const auto&... column){ return std::tuple<const Fields&...>(column[index]...); }, m_columns);
+        }
+
+        /**
+         * Returns one column as a contiguous span. The span is invalidated by anything that adds rows
+        */
+        template<size_t Column>
+        std::span<column_type<Column>> column() noexcept {
+            auto& c = std::get<Column>(m_columns);
+            return std::span<column_type<Column>>(c.data(), c.size());
+        }
+
+        template<size_t Column>
+        std::span<const column_type<Column>> column() const noexcept {
+            const auto& c = std::get<Column>(m_columns);
+            return std::span<const column_type<Column>>(c.data(), c.size());
+        }
+
+        /**
+         * Sorts the rows by @param Column (ascending by operator<), keeping rows with equal keys in their current order.
+         * The key column is sorted together with each row's index using custom::sort, and the resulting permutation is then applied to every other column,
+         * one column at a time. Integer keys of up to 32 bits are packed with the index into a single 64 bit integer, so custom::sort can radix sort them
+        */
+        template<size_t Column>
+        void sort_by() {
+            using Key = column_type<Column>;
+            const size_t n = size();
+            if(n < 2) return;
+            auto& keys = std::get<Column>(m_columns);
+            myVector<size_t> order;
+            order.resize_for_overwrite(n);
+
+            if constexpr (std::is_integral_v<Key> && !std::is_same_v<Key, bool> && sizeof(Key) <= 4){
+                if(n <= std::numeric_limits<uint32_t>::max()){
+                    myVector<uint64_t> packed;
+                    packed.resize_for_overwrite(n);
+                    for(size_t i = 0; i < n; ++i) packed[i] = uint64_t(orderedBits(keys[i])) << 32 | i; //Key in the high half, row in the low half, so ties keep their order
+                    custom::sort(packed.data(), packed.data() + n);
+                    for(size_t i = 0; i < n; ++i) order[i] = size_t(packed[i] & 0xFFFFFFFFu);
+                    applyOrder(order, std::index_sequence_for<Fields...>());
+                    return;
+                }
+            }
+
+            myVector<detail::keyedRow<Key>> rows;
+            rows.reserve(n);
+            for(size_t i = 0; i < n; ++i) rows.push_back({std::move(keys[i]), i});
+            custom::sort(rows.data(), rows.data() + n);
+            for(size_t i = 0; i < n; ++i){
+                order[i] = rows[i].row;
+                keys[i] = std::move(rows[i].key); //The keys come back out already in order, so the key column skips the gather
+            }
+            applyOrder<Column>(order, std::index_sequence_for<Fields...>());
+        }
+
+        void reserve(size_t capacity) {
+            std::apply([capacity](auto&... column){ (column.reserve(capacity), ...); }, m_columns);
+        }
+
+        void resize(size_t newSize) {
+            std::apply([newSize](auto&... column){ (column.resize(newSize), ...); }, m_columns);
+        }
+
+        void clear() noexcept {
+            std::apply([](auto&... column){ (column.clear(), ...); }, m_columns);
+        }
+
+        void shrink_to_fit() {
+            std::apply([](auto&... column){ (column.shrink_to_fit(), ...); }, m_columns);
+        }
+
+        [[nodiscard]] bool isEmpty() const noexcept { return size() == 0; }
+        size_t size() const noexcept { return std::get<0>(m_columns).size(); }
+        size_t capacity() const noexcept { return std::get<0>(m_columns).capacity(); }
+
+    private:
+        std::tuple<myVector<Fields>...> m_columns;
+
+        template<size_t... Columns, typename... Args>
+        void emplaceColumns(std::index_sequence<Columns...>, size_t& added, Args&&... args) {
+            ((std::get<Columns>(m_columns).emplace_back(std::forward<Args>(args)), ++added), ...);
+        }
+
+        template<size_t... Columns>
+        void popColumns(std::index_sequence<Columns...>, size_t added) noexcept {
+            ((Columns < added ? std::get<Columns>(m_columns).pop_back() : void()), ...);
+        }
+
+        /**
+         * Maps an integer key to an unsigned value with the same order, by flipping the sign bit of signed keys
+        */
+        template<typename Key>
+        static uint32_t orderedBits(Key key) noexcept {
+            if constexpr (std::is_signed_v<Key>) return uint32_t(int64_t(key) - int64_t(std::numeric_limits<Key>::min()));
+            else return uint32_t(key);
+        }
+
+        /**
+         * Reorders every column (except @param Skip, if it is a valid column) so row i becomes the old row order[i]
+        */
+        template<size_t Skip = columns, size_t... Columns>
+        void applyOrder(const myVector<size_t>& order, std::index_sequence<Columns...>) {
+            ((Columns != Skip ? gather(std::get<Columns>(m_columns), order) : void()), ...);
+        }
+
+        template<typename T>
+        static void gather(myVector<T>& column, const myVector<size_t>& order) {
+            myVector<T> sorted(column.get_allocator());
+            sorted.reserve(order.size());
+            for(size_t i = 0; i < order.size(); ++i) sorted.push_back(std::move(column[order[i]]));
+            column.swap(sorted);
+        }
+    };
+}
+#endif //SOAVEC
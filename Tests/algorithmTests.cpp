@@ -0,0 +1,115 @@
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+#include "merge.hpp"
+#include "select.hpp"
+#include "sort.hpp"
+#include "threadPool.hpp"
+#include "testing.hpp"
+
+/**
+ * Checks the algorithms beyond the plain sorts against their std equivalents, on inputs big enough to take their parallel or multi-pass paths
+*/
+namespace{
+    /**
+     * The parallel sort on the shared pool and on pools of its own, with a grain small enough that the range is split into many tasks
+    */
+    void check_parallel_sort(){
+        std::mt19937 rng(2024);
+        std::vector<int> input(200000);
+        for(int& item : input) item = int(rng() % 1000);
+        std::vector<int> expected = input;
+        std::sort(expected.begin(), expected.end());
+
+        std::vector<int> items = input;
+        custom::sort(custom::execution::par, items.begin(), items.end());
+        CHECK(items == expected);
+
+        for(size_t workers : {1, 2, 4}){
+            custom::threadPool pool(workers);
+            items = input;
+            custom::sort(custom::execution::par.on(pool).with_grain(1000), items.begin(), items.end());
+            CHECK(items == expected);
+        }
+
+        std::vector<std::string> words; //Not radix sortable, so every task runs introsort
+        for(int i = 0; i < 50000; ++i) words.push_back(std::to_string(rng()));
+        std::vector<std::string> sorted_words = words;
+        std::sort(sorted_words.begin(), sorted_words.end());
+        custom::sort(custom::execution::par.with_grain(512), words.begin(), words.end());
+        CHECK(words == sorted_words);
+    }
+
+    struct tagged{
+        int key;
+        int origin; //Which range the item came from, to check stability
+        bool operator<(const tagged& other) const noexcept { return key < other.key; }
+        bool operator==(const tagged& other) const noexcept = default;
+    };
+
+    /**
+     * The parallel merge splits the output along the merge path. Ties between the ranges have to stay in order across the split points
+    */
+    void check_merge(){
+        std::mt19937 rng(77);
+        for(size_t length : {0, 1, 1000, 100000}){
+            std::vector<tagged> a(length), b(length / 2 + 3);
+            for(tagged& item : a) item = {int(rng() % 50), 0};
+            for(tagged& item : b) item = {int(rng() % 50), 1};
+            std::sort(a.begin(), a.end());
+            std::sort(b.begin(), b.end());
+            std::vector<tagged> expected(a.size() + b.size());
+            std::merge(a.begin(), a.end(), b.begin(), b.end(), expected.begin());
+
+            std::vector<tagged> out(expected.size());
+            custom::merge(a.begin(), a.end(), b.begin(), b.end(), out.begin());
+            CHECK(out == expected);
+
+            custom::threadPool pool(4);
+            std::fill(out.begin(), out.end(), tagged{-1, -1});
+            custom::merge(custom::execution::par.on(pool).with_grain(100), a.begin(), a.end(), b.begin(), b.end(), out.begin());
+            CHECK(out == expected);
+        }
+    }
+
+    /**
+     * nth_element, partial_sort and top_k on random data, on all-equal data, and on a median-of-3 killer that pushes introselect to its fallback
+    */
+    void check_selection(){
+        std::mt19937 rng(8);
+        std::vector<int> random(10000), equal(10000, 7), killer(10000);
+        for(int& item : random) item = int(rng() % 100000);
+        for(size_t i = 0; i < killer.size() / 2; ++i){ //Organ pipe: median-of-3 keeps picking bad pivots
+            killer[i] = int(i);
+            killer[killer.size() - 1 - i] = int(i);
+        }
+        for(const std::vector<int>* input : {&random, &equal, &killer}){
+            std::vector<int> sorted = *input;
+            std::sort(sorted.begin(), sorted.end());
+            for(size_t nth : {size_t(0), size_t(1), input->size() / 2, input->size() - 1}){
+                std::vector<int> items = *input;
+                custom::nth_element(items.begin(), items.begin() + nth, items.end());
+                CHECK(items[nth] == sorted[nth]);
+                CHECK(std::all_of(items.begin(), items.begin() + nth, [&](int x){ return x <= items[nth]; }));
+                CHECK(std::all_of(items.begin() + nth, items.end(), [&](int x){ return x >= items[nth]; }));
+            }
+
+            std::vector<int> items = *input;
+            custom::partial_sort(items.begin(), items.begin() + 100, items.end());
+            CHECK(std::equal(items.begin(), items.begin() + 100, sorted.begin()));
+
+            std::vector<int> best(100);
+            CHECK(custom::top_k(input->begin(), input->end(), best.size(), best.begin()) == best.end());
+            CHECK(std::equal(best.begin(), best.end(), sorted.rbegin()));
+        }
+    }
+}
+
+int main(){
+    check_parallel_sort();
+    check_merge();
+    check_selection();
+    return testing::finish("algorithmTests");
+}
@@ -0,0 +1,59 @@
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <vector>
+#include "concurrentVector.hpp"
+#include "testing.hpp"
+
+/**
+ * Checks that concurrent push_backs each get their own slot, that every pushed object is published intact, and that addresses never move
+*/
+namespace{
+    void check_concurrent_push(){
+        constexpr int threads = 4, per_thread = 20000;
+        custom::concurrentVector<int> c;
+        std::vector<std::vector<size_t>> indexes(threads);
+        std::vector<std::thread> workers;
+        for(int t = 0; t < threads; ++t){
+            workers.emplace_back([&c, &indexes, t]{
+                for(int i = 0; i < per_thread; ++i) indexes[t].push_back(c.push_back(t * per_thread + i));
+            });
+        }
+        for(std::thread& worker : workers) worker.join();
+        CHECK(c.size() == size_t(threads * per_thread));
+
+        std::vector<int> seen;
+        bool ordered = true;
+        for(int t = 0; t < threads; ++t){
+            for(int i = 0; i < per_thread; ++i){
+                const size_t index = indexes[t][i];
+                ordered &= c.is_published(index) && c[index] == t * per_thread + i;
+                if(i > 0) ordered &= index > indexes[t][i - 1]; //A thread's own pushes land in the order it made them
+            }
+        }
+        for(size_t i = 0; i < c.size(); ++i) seen.push_back(c[i]);
+        std::sort(seen.begin(), seen.end());
+        CHECK(ordered);
+        CHECK(std::adjacent_find(seen.begin(), seen.end()) == seen.end() && seen.front() == 0 && seen.back() == threads * per_thread - 1);
+    }
+
+    void check_stable_addresses(){
+        custom::concurrentVector<std::string> c;
+        c.reserve(100);
+        const size_t first = c.push_back("first");
+        const std::string* address = c.get(first);
+        for(int i = 0; i < 100000; ++i) c.push_back(std::to_string(i));
+        CHECK(c.get(first) == address && *address == "first" && c[100000] == "99999");
+        CHECK(!c.is_published(c.size()) && c.get(c.size()) == nullptr);
+        c.clear();
+        CHECK(c.size() == 0);
+        c.push_back("again");
+        CHECK(c.size() == 1 && c[0] == "again");
+    }
+}
+
+int main(){
+    check_concurrent_push();
+    check_stable_addresses();
+    return testing::finish("concurrentVectorTests");
+}
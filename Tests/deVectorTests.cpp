@@ -0,0 +1,67 @@
+#include <algorithm>
+#include <deque>
+#include <random>
+#include <string>
+#include "deVector.hpp"
+#include "testing.hpp"
+
+/**
+ * Checks deVector against std::deque through random pushes and pops at both ends, and that a queue that only ever holds a few objects
+ * recenters its buffer instead of growing it
+*/
+namespace{
+    template<class Vector>
+    bool same(const Vector& vec, const std::deque<typename Vector::value_type>& expected){
+        return vec.size() == expected.size() && std::equal(expected.begin(), expected.end(), vec.begin());
+    }
+
+    void check_both_ends(){
+        std::mt19937 rng(22);
+        custom::deVector<std::string> d;
+        std::deque<std::string> expected;
+        bool agree = true;
+        for(int i = 0; i < 20000; ++i){
+            const std::string value = std::to_string(i);
+            switch(rng() % 6){
+                case 0: case 1: d.push_back(value); expected.push_back(value); break;
+                case 2: case 3: d.push_front(value); expected.push_front(value); break;
+                case 4: if(!expected.empty()){ d.pop_back(); expected.pop_back(); } break;
+                default: if(!expected.empty()){ d.pop_front(); expected.pop_front(); } break;
+            }
+            agree &= d.size() == expected.size() && (expected.empty() || (d.front() == expected.front() && d.back() == expected.back()));
+        }
+        CHECK(agree && same(d, expected));
+
+        custom::deVector<std::string> copy = d;
+        CHECK(same(copy, expected));
+        d.shrink_to_fit();
+        CHECK(d.capacity() == d.size() && same(d, expected));
+        d.resize(3);
+        expected.resize(3);
+        CHECK(same(d, expected));
+    }
+
+    void check_queue(){
+        custom::deVector<int> queue;
+        for(int i = 0; i < 8; ++i) queue.push_back(i);
+        const size_t capacity = queue.capacity();
+        for(int i = 8; i < 100000; ++i){ //FIFO: push at the back, pop from the front. Free slots at the front are reused, not leaked
+            queue.push_back(i);
+            queue.pop_front();
+        }
+        CHECK(queue.size() == 8 && queue.front() == 99992 && queue.back() == 99999);
+        CHECK(queue.capacity() <= 2 * capacity + 2);
+
+        custom::deVector<int> front;
+        front.reserve_front(100);
+        CHECK(front.front_capacity() >= 100);
+        for(int i = 0; i < 100; ++i) front.push_front(i);
+        CHECK(front.front() == 99 && front.back() == 0 && front.capacity() == front.size() + front.front_capacity() + front.back_capacity());
+    }
+}
+
+int main(){
+    check_both_ends();
+    check_queue();
+    return testing::finish("deVectorTests");
+}
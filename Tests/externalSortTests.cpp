@@ -0,0 +1,111 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <new>
+#include <random>
+#include <vector>
+#include "externalSort.hpp"
+#include "testing.hpp"
+
+/**
+ * Checks that custom::external_sort sorts files that need several runs, and that it stays within options.memory_budget.
+ * Every allocation in this executable goes through the operator new below, which keeps track of the most bytes live at once
+*/
+namespace{
+    size_t live_bytes = 0;
+    size_t peak_bytes = 0;
+}
+
+void* operator new(size_t bytes){
+    void* block = std::malloc(bytes + 16); //16 bytes in front remember the size, and keep the result 16 byte aligned
+    if(!block) throw std::bad_alloc();
+    *static_cast<size_t*>(block) = bytes;
+    live_bytes += bytes;
+    peak_bytes = std::max(peak_bytes, live_bytes);
+    return static_cast<char*>(block) + 16;
+}
+
+void operator delete(void* p) noexcept {
+    if(!p) return;
+    void* block = static_cast<char*>(p) - 16;
+    live_bytes -= *static_cast<size_t*>(block);
+    std::free(block);
+}
+
+void operator delete(void* p, size_t) noexcept { operator delete(p); }
+
+namespace{
+    template<typename Record>
+    std::vector<Record> sort_file(const std::vector<Record>& records, const custom::external_sort_options& options, size_t& peak){
+        const std::filesystem::path input = std::filesystem::temp_directory_path() / "custom_externalSortTests_unsorted.bin";
+        const std::filesystem::path output = std::filesystem::temp_directory_path() / "custom_externalSortTests_sorted.bin";
+        std::FILE* file = std::fopen(input.string().c_str(), "wb");
+        std::fwrite(records.data(), sizeof(Record), records.size(), file);
+        std::fclose(file);
+
+        const size_t before = live_bytes;
+        peak_bytes = live_bytes;
+        custom::external_sort<Record>(input, output, options);
+        peak = peak_bytes - before;
+
+        std::vector<Record> sorted(records.size());
+        file = std::fopen(output.string().c_str(), "rb");
+        CHECK(std::fread(sorted.data(), sizeof(Record), sorted.size(), file) == sorted.size());
+        std::fclose(file);
+        std::filesystem::remove(input);
+        std::filesystem::remove(output);
+        return sorted;
+    }
+
+    /**
+     * Arithmetic records are radix sorted, which needs a scratch buffer as big as the chunk. Both have to fit in the budget.
+     * The allowance on top of it covers the radix sort's histograms, the run list and the file paths
+    */
+    void check_budget(){
+        std::mt19937_64 rng(12345);
+        std::vector<uint64_t> records(size_t(1) << 20); //8 MB
+        for(uint64_t& record : records) record = rng();
+        custom::external_sort_options options;
+        options.memory_budget = size_t(2) << 20; //Forces several runs
+        options.block_size = size_t(64) << 10;
+        size_t peak = 0;
+        std::vector<uint64_t> sorted = sort_file(records, options, peak);
+        std::sort(records.begin(), records.end());
+        CHECK(sorted == records);
+        CHECK(peak <= options.memory_budget + (size_t(256) << 10));
+
+        std::vector<int32_t> small(5000); //Fits in memory, so it is sorted in one chunk without a merge
+        for(size_t i = 0; i < small.size(); ++i) small[i] = int32_t(small.size() - i) - 2500;
+        std::vector<int32_t> small_sorted = sort_file(small, options, peak);
+        std::sort(small.begin(), small.end());
+        CHECK(small_sorted == small);
+        CHECK(peak <= options.memory_budget + (size_t(256) << 10));
+    }
+
+    struct record{
+        uint32_t key;
+        char payload[12];
+        bool operator<(const record& other) const noexcept { return key < other.key; }
+    };
+
+    void check_records(){
+        std::mt19937 rng(54321);
+        std::vector<record> records(100000);
+        for(record& r : records) r.key = uint32_t(rng());
+        custom::external_sort_options options;
+        options.memory_budget = size_t(256) << 10;
+        options.block_size = size_t(4) << 10;
+        size_t peak = 0;
+        std::vector<record> sorted = sort_file(records, options, peak);
+        CHECK(std::is_sorted(sorted.begin(), sorted.end()));
+        CHECK(peak <= options.memory_budget + (size_t(256) << 10));
+    }
+}
+
+int main(){
+    check_budget();
+    check_records();
+    return testing::finish("externalSortTests");
+}
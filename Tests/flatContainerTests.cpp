@@ -0,0 +1,76 @@
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "flatMap.hpp"
+#include "flatSet.hpp"
+#include "testing.hpp"
+
+/**
+ * Checks flatSet and flatMap against std::set and std::map, through single inserts, bulk inserts that have to be merged into existing keys, and erases
+*/
+namespace{
+    void check_flatSet(){
+        std::mt19937 rng(19);
+        std::vector<int> keys(5000);
+        for(int& key : keys) key = int(rng() % 3000);
+        custom::flatSet<int> set(keys.begin(), keys.end());
+        std::set<int> expected(keys.begin(), keys.end());
+        CHECK(set.size() == expected.size() && std::equal(set.begin(), set.end(), expected.begin()));
+
+        for(int& key : keys) key = int(rng() % 6000); //Half of them already in the set
+        set.insert(keys.begin(), keys.end());
+        expected.insert(keys.begin(), keys.end());
+        CHECK(set.size() == expected.size() && std::equal(set.begin(), set.end(), expected.begin()));
+
+        CHECK(!set.insert(*expected.begin()).second && set.insert(-1).second);
+        expected.insert(-1);
+        for(int key = 0; key < 6000; key += 7) CHECK(set.erase(key) == expected.erase(key));
+        CHECK(set.size() == expected.size() && std::equal(set.begin(), set.end(), expected.begin()));
+        CHECK(*set.lower_bound(100) == *expected.lower_bound(100) && *set.upper_bound(100) == *expected.upper_bound(100));
+        CHECK(set.contains(-1) && set.count(7) == 0);
+
+        custom::flatSet<int, std::greater<int>> descending{1, 3, 2, 3};
+        CHECK(descending.size() == 3 && *descending.begin() == 3);
+    }
+
+    void check_flatMap(){
+        custom::flatMap<std::string, int> map{{"b", 2}, {"a", 1}, {"b", 20}}; //The first of equal keys wins, like std::map
+        std::map<std::string, int> expected{{"b", 2}, {"a", 1}, {"b", 20}};
+        map["c"] = 3;
+        expected["c"] = 3;
+        map.insert_or_assign("a", 10);
+        expected.insert_or_assign("a", 10);
+        CHECK(!map.try_emplace("c", 30).second);
+        std::vector<std::pair<std::string, int>> more;
+        for(int i = 0; i < 100; ++i) more.emplace_back(std::to_string(i), i);
+        map.insert(more.begin(), more.end());
+        expected.insert(more.begin(), more.end());
+        CHECK(map.erase("b") == 1 && expected.erase("b") == 1 && map.erase("b") == 0);
+
+        CHECK(map.size() == expected.size());
+        bool same = true;
+        auto it = expected.begin();
+        for(const auto& entry : map){
+            same &= entry.first == it->first && entry.second == it->second;
+            ++it;
+        }
+        CHECK(same);
+        CHECK(map.at("a") == 10 && map.find("zz") == map.end() && map.contains("42"));
+
+        bool threw = false;
+        try{ (void)map.at("zz"); }
+        catch(const std::out_of_range&){ threw = true; }
+        CHECK(threw);
+    }
+}
+
+int main(){
+    check_flatSet();
+    check_flatMap();
+    return testing::finish("flatContainerTests");
+}
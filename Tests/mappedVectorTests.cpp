@@ -0,0 +1,65 @@
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <stdexcept>
+#include "mappedVector.hpp"
+#include "sort.hpp"
+#include "testing.hpp"
+
+/**
+ * Checks that a mappedVector's records survive in its file, that the file ends up exactly size() records long,
+ * and that readOnly and copyOnWrite views never change the file
+*/
+namespace{
+    struct record{
+        uint64_t key;
+        double value;
+        bool operator<(const record& other) const noexcept { return key < other.key; }
+    };
+
+    void check_mappedVector(){
+        const std::filesystem::path path = std::filesystem::temp_directory_path() / "custom_mappedVectorTests.bin";
+        std::filesystem::remove(path);
+        {
+            custom::mappedVector<record> m(path.string());
+            for(uint64_t i = 0; i < 100000; ++i) m.push_back(record{(i * 7919) % 100000, double(i)});
+            m.pop_back();
+            CHECK(m.size() == 99999 && m.capacity() >= m.size());
+            custom::sort(m.begin(), m.end()); //Sorts the file in place
+        }
+        CHECK(std::filesystem::file_size(path) == 99999 * sizeof(record)); //Cut back down from its capacity
+
+        {
+            custom::mappedVector<record> m(path.string(), custom::mapMode::readOnly);
+            CHECK(m.size() == 99999);
+            CHECK(std::is_sorted(m.begin(), m.end()));
+            bool threw = false;
+            try{ m.push_back(record{0, 0}); }
+            catch(const std::logic_error&){ threw = true; }
+            CHECK(threw && m.size() == 99999);
+        }
+
+        {
+            custom::mappedVector<record> m(path.string(), custom::mapMode::copyOnWrite);
+            m[0].value = -1;
+            for(int i = 0; i < 1000; ++i) m.push_back(record{0, 0}); //Past the file's size, so the records move to anonymous memory
+            CHECK(m.size() == 100999 && m[0].value == -1 && m[99998].key == 99999);
+        }
+        CHECK(std::filesystem::file_size(path) == 99999 * sizeof(record));
+
+        {
+            custom::mappedVector<record> m(path.string());
+            CHECK(m.front().key == 0 && m.front().value != -1); //The copy-on-write change never reached the file
+            m.resize(10);
+            m.shrink_to_fit();
+            CHECK(m.size() == 10 && m.back().key == 9);
+        }
+        CHECK(std::filesystem::file_size(path) == 10 * sizeof(record));
+        std::filesystem::remove(path);
+    }
+}
+
+int main(){
+    check_mappedVector();
+    return testing::finish("mappedVectorTests");
+}
@@ -0,0 +1,318 @@
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <list>
+#include <memory>
+#include <memory_resource>
+#include <ranges>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+#include "allocators.hpp"
+#include "myIterator.hpp"
+#include "myVector.hpp"
+#include "testing.hpp"
+
+/**
+ * Checks myVector's operations against std::vector, one group per feature: allocators, inline capacity, relocation, bulk inserts, erasing,
+ * uninitialized resizes, growth policies, aligned storage and its iterators
+*/
+namespace{
+    template<class Vector>
+    bool same(const Vector& vec, const std::vector<typename Vector::value_type>& expected){
+        return vec.size() == expected.size() && std::equal(expected.begin(), expected.end(), vec.begin());
+    }
+
+    /**
+     * The arena, pool and pmr allocators, and that copies and swaps keep their own allocator like std::pmr containers do
+    */
+    void check_allocators(){
+        custom::monotonicArena arena;
+        custom::myVector<std::string, custom::arenaAllocator<std::string>> a(arena);
+        std::vector<std::string> expected;
+        for(int i = 0; i < 1000; ++i){
+            a.push_back(std::to_string(i));
+            expected.push_back(std::to_string(i));
+        }
+        CHECK(same(a, expected));
+        CHECK(arena.chunk_bytes() > 0);
+
+        custom::monotonicArena other;
+        custom::myVector<std::string, custom::arenaAllocator<std::string>> copy(other);
+        copy = a;
+        CHECK(same(copy, expected) && copy.get_allocator().arena() == &other);
+
+        custom::fixedPool pool(64);
+        custom::myVector<int, custom::poolAllocator<int>> p(pool);
+        for(int i = 0; i < 100; ++i) p.push_back(i);
+        CHECK(p.size() == 100 && p[99] == 99 && p.get_allocator().pool() == &pool);
+
+        std::pmr::monotonic_buffer_resource resource;
+        custom::pmr::myVector<int> m(&resource);
+        for(int i = 0; i < 1000; ++i) m.push_back(i);
+        CHECK(m.size() == 1000 && m[500] == 500 && m.get_allocator().resource() == &resource);
+    }
+
+    /**
+     * smallVector stays inline up to its capacity, spills to the heap past it, and moves and swaps across the two
+    */
+    void check_smallVector(){
+        custom::smallVector<std::string, 4> small;
+        std::vector<std::string> expected;
+        for(int i = 0; i < 4; ++i){
+            small.push_back(std::to_string(i));
+            expected.push_back(std::to_string(i));
+        }
+        CHECK(small.isInline() && small.capacity() == 4 && same(small, expected));
+        small.push_back("4");
+        expected.push_back("4");
+        CHECK(!small.isInline() && same(small, expected));
+
+        custom::smallVector<std::string, 4> inlined{"a", "b"};
+        custom::smallVector<std::string, 4> moved(std::move(inlined));
+        CHECK(moved.isInline() && same(moved, {"a", "b"}));
+        moved.swap(small);
+        CHECK(same(moved, expected) && same(small, {"a", "b"}) && small.isInline());
+
+        custom::smallVector<std::string, 4> copy = moved;
+        CHECK(same(copy, expected));
+        copy.clear();
+        copy.shrink_to_fit();
+        CHECK(copy.isInline() && copy.size() == 0);
+    }
+
+    /**
+     * Trivially relocatable objects are grown, inserted and erased with memcpy/memmove, and big buffers of them grow with mremap on Linux.
+     * unique_ptr is relocatable but not trivially copyable, so losing or duplicating one shows up as a wrong value or a double free
+    */
+    void check_relocation(){
+        custom::myVector<std::unique_ptr<int>> owners;
+        for(int i = 0; i < 1000; ++i) owners.push_back(std::make_unique<int>(i));
+        owners.emplace(owners.begin() + 10, std::make_unique<int>(-1));
+        owners.erase(owners.begin());
+        owners.push_front(std::make_unique<int>(-2));
+        CHECK(owners.size() == 1001 && *owners[0] == -2 && *owners[10] == -1 && *owners[11] == 10 && *owners[1000] == 999);
+        owners.shrink_to_fit();
+        CHECK(owners.capacity() == 1001 && *owners[1000] == 999);
+
+        custom::myVector<int64_t> big; //Past 4 MB, so it is mapped and grows with mremap where that is available
+        for(int64_t i = 0; i < 2000000; ++i) big.push_back(i);
+        bool intact = true;
+        for(int64_t i = 0; i < 2000000; ++i) intact &= big[size_t(i)] == i;
+        CHECK(intact);
+        big.erase(big.begin(), big.begin() + 1500000);
+        big.shrink_to_fit();
+        CHECK(big.size() == 500000 && big.capacity() == 500000 && big.front() == 1500000 && big.back() == 1999999);
+        custom::myVector<int64_t> moved = std::move(big);
+        CHECK(moved.size() == 500000 && big.size() == 0);
+    }
+
+    /**
+     * Range inserts from forward and single pass iterators, repeated values that alias the vector, append_range, assign and the iterator pair constructor
+    */
+    void check_bulk_insert(){
+        std::list<std::string> words{"x", "y", "z"};
+        custom::myVector<std::string> v(words.begin(), words.end());
+        std::vector<std::string> expected(words.begin(), words.end());
+        CHECK(same(v, expected));
+
+        std::vector<std::string> more{"a", "b", "c", "d", "e", "f", "g", "h"};
+        CHECK(*v.insert(v.begin() + 1, more.begin(), more.end()) == "a");
+        expected.insert(expected.begin() + 1, more.begin(), more.end());
+        CHECK(same(v, expected));
+
+        std::istringstream stream("p q r");
+        v.insert(v.begin() + 2, std::istream_iterator<std::string>(stream), std::istream_iterator<std::string>());
+        expected.insert(expected.begin() + 2, {"p", "q", "r"});
+        CHECK(same(v, expected));
+
+        v.insert(v.begin(), 20, v.back()); //The value is in the vector, and moves when it grows
+        expected.insert(expected.begin(), 20, expected.back());
+        CHECK(same(v, expected));
+
+        v.append_range(words);
+        expected.insert(expected.end(), words.begin(), words.end());
+        CHECK(same(v, expected));
+
+        v.assign(more.begin(), more.begin() + 3);
+        CHECK(same(v, {"a", "b", "c"}));
+
+        custom::myVector<int> numbers;
+        numbers.append_range(std::views::iota(0, 1000));
+        CHECK(numbers.size() == 1000 && numbers[999] == 999);
+    }
+
+    /**
+     * Range erase, erase_if and unordered_erase, on a relocatable type and on one that isn't
+    */
+    void check_erase(){
+        custom::myVector<int> v;
+        std::vector<int> expected;
+        for(int i = 0; i < 1000; ++i){
+            v.push_back(i);
+            expected.push_back(i);
+        }
+        CHECK(*v.erase(v.begin() + 100, v.begin() + 200) == 200);
+        expected.erase(expected.begin() + 100, expected.begin() + 200);
+        CHECK(same(v, expected));
+        const auto end = v.erase(v.end(), v.end());
+        CHECK(end == v.end());
+
+        CHECK(custom::erase_if(v, [](int x){ return x % 3 == 0; }) == size_t(std::erase_if(expected, [](int x){ return x % 3 == 0; })));
+        CHECK(same(v, expected));
+
+        custom::myVector<std::string> s{"a", "b", "c", "d"};
+        CHECK(*s.unordered_erase(s.begin() + 1) == "d");
+        CHECK(same(s, {"a", "d", "c"}));
+        const auto last = s.unordered_erase(s.end() - 1);
+        CHECK(last == s.end());
+        CHECK(same(s, {"a", "d"}));
+        CHECK(custom::erase_if(s, [](const std::string& x){ return x == "a"; }) == 1 && same(s, {"d"}));
+    }
+
+    /**
+     * resize_for_overwrite and resize_and_overwrite, used the way an I/O loop would use them
+    */
+    void check_overwrite(){
+        custom::myVector<char> buffer;
+        buffer.resize_for_overwrite(10);
+        std::fill(buffer.begin(), buffer.end(), 'x');
+        CHECK(buffer.size() == 10 && buffer[9] == 'x');
+        buffer.resize_for_overwrite(4);
+        CHECK(buffer.size() == 4 && buffer.capacity() >= 10);
+
+        const std::string text = "the quick brown fox jumps over the lazy dog";
+        size_t read = 0;
+        while(read < text.size()){ //Appends chunks of up to 8 bytes, like read() filling a buffer
+            buffer.resize_and_overwrite(buffer.size() + 8, [&](char* p, size_t n){
+                const size_t chunk = std::min<size_t>(8, text.size() - read);
+                std::copy_n(text.data() + read, chunk, p + n - 8);
+                read += chunk;
+                return n - 8 + chunk;
+            });
+        }
+        CHECK(std::string(buffer.begin(), buffer.end()) == "xxxx" + text);
+
+        bool threw = false;
+        try{ buffer.resize_and_overwrite(2, [](char*, size_t n){ return n + 1; }); }
+        catch(const std::length_error&){ threw = true; }
+        CHECK(threw);
+    }
+
+    struct noGrowth{
+        static constexpr size_t next_capacity(size_t capacity) noexcept { return capacity; }
+    };
+
+    /**
+     * The growth policy decides the next capacity, but a full vector always grows by at least one object
+    */
+    void check_growth_policy(){
+        custom::myVector<int, std::allocator<int>, 0, custom::geometricGrowth<2, 1, 0>> doubling;
+        for(int i = 0; i < 100; ++i) doubling.push_back(i);
+        CHECK(doubling.capacity() == 128);
+
+        custom::myVector<int> standard; //1.5x + 1: 1, 2, 4, 7
+        for(int i = 0; i < 5; ++i) standard.push_back(i);
+        CHECK(standard.capacity() == 7);
+
+        custom::myVector<int, std::allocator<int>, 0, noGrowth> exact;
+        for(int i = 0; i < 10; ++i) exact.push_back(i);
+        CHECK(exact.capacity() == 10 && exact[9] == 9);
+    }
+
+    /**
+     * alignedVector's buffers start on the requested boundary, including after it grows and shrinks
+    */
+    void check_alignedVector(){
+        custom::alignedVector<float, 64> aligned(100);
+        CHECK(reinterpret_cast<std::uintptr_t>(aligned.data()) % 64 == 0);
+        for(int i = 0; i < 10000; ++i) aligned.push_back(float(i));
+        CHECK(reinterpret_cast<std::uintptr_t>(aligned.data()) % 64 == 0);
+        aligned.shrink_to_fit();
+        CHECK(reinterpret_cast<std::uintptr_t>(aligned.data()) % 64 == 0 && aligned.back() == 9999.0f);
+
+        custom::alignedVector<std::string, 128> strings{"a", "b"};
+        strings.push_back("c");
+        CHECK(reinterpret_cast<std::uintptr_t>(strings.data()) % 128 == 0 && strings[2] == "c");
+    }
+
+    /**
+     * Capacities around 2 MB, where the vector and the allocator have to agree on which buffers are mapped.
+     * 87381 of a 24 byte struct is 2,097,144 bytes, just under 2 MB, where a count threshold rounded down used to call it mapped
+    */
+    void check_hugePageVector(){
+        struct record{ int64_t a, b, c; };
+        static_assert(sizeof(record) == 24);
+        for(size_t n : {87380, 87381, 87382, 87383}){
+            custom::hugePageVector<record> v;
+            v.reserve(n);
+            CHECK(v.capacity() >= n);
+            const size_t count = v.capacity() + 1000; //Grows across the boundary
+            for(size_t i = 0; i < count; ++i) v.push_back(record{int64_t(i), -int64_t(i), 7});
+            bool intact = true;
+            for(size_t i = 0; i < count; ++i) intact &= v[i].a == int64_t(i) && v[i].b == -int64_t(i) && v[i].c == 7;
+            CHECK(intact);
+            v.shrink_to_fit();
+            CHECK(v.size() == count && v[count - 1].a == int64_t(count - 1));
+        }
+        custom::hugePageVector<int> big(size_t(1) << 20);
+        CHECK(reinterpret_cast<std::uintptr_t>(big.data()) % (size_t(2) << 20) == 0);
+#if defined(__linux__) && defined(MAP_FIXED_NOREPLACE)
+        //Block the address space right after the buffer, so growing it can't happen in place and the pages have to move
+        void* blocker = mmap(big.data() + big.capacity(), 4096, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+        big.push_back(1);
+        CHECK(reinterpret_cast<std::uintptr_t>(big.data()) % (size_t(2) << 20) == 0); //Still 2 MB aligned after the move
+        CHECK(big.size() == (size_t(1) << 20) + 1 && big.back() == 1);
+        if(blocker != MAP_FAILED) munmap(blocker, 4096);
+#endif
+    }
+
+    static_assert(std::contiguous_iterator<custom::myIterator<int>> && std::contiguous_iterator<custom::myIterator<const int>>);
+    static_assert(std::is_convertible_v<custom::myIterator<int>, custom::myIterator<const int>>);
+    static_assert(!std::is_convertible_v<custom::myIterator<const int>, custom::myIterator<int>>); //Never drops const
+
+    constexpr int sum_in_constexpr(){
+        int items[] = {1, 2, 3, 4};
+        custom::myIterator<int> first(items), last(items + 4);
+        int sum = 0;
+        for(custom::myIterator<int> it = first; it != last; ++it) sum += *it;
+        return sum + int(last - first) + first[3];
+    }
+    static_assert(sum_in_constexpr() == 10 + 4 + 4);
+
+    /**
+     * myIterator is a contiguous iterator at runtime too: std::to_address, ranges algorithms and reverse iteration
+    */
+    void check_iterators(){
+        custom::myVector<int> v;
+        for(int i = 0; i < 100; ++i) v.push_back(i);
+        CHECK(std::to_address(v.begin()) == v.data() && std::to_address(v.end()) == v.data() + v.size());
+
+        std::vector<int> copy(v.size());
+        std::ranges::copy(v, copy.begin());
+        CHECK(same(v, copy));
+        CHECK(std::vector<int>(v.rbegin(), v.rend()).front() == 99);
+
+        custom::myIterator<const int> c = v.begin();
+        CHECK(c == v.cbegin() && c + 5 > c && *(c + 5) == 5 && v.end() - c == 100);
+    }
+}
+
+int main(){
+    check_allocators();
+    check_smallVector();
+    check_relocation();
+    check_bulk_insert();
+    check_erase();
+    check_overwrite();
+    check_growth_policy();
+    check_alignedVector();
+    check_hugePageVector();
+    check_iterators();
+    return testing::finish("myVectorTests");
+}
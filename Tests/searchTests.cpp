@@ -0,0 +1,93 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
+#include "myVector.hpp"
+#include "search.hpp"
+#include "sort.hpp"
+#include "testing.hpp"
+
+/**
+ * Checks the SIMD find and count against the plain loop at every length and match position around the register widths,
+ * and the sorted searches against std::lower_bound
+*/
+namespace{
+    template<typename T>
+    void check_scan(std::mt19937& rng){
+        for(size_t n = 0; n <= 300; ++n){
+            std::vector<T> items(n);
+            for(T& item : items) item = T(rng() % 4 + 1); //Never 0, so 0 only matches where it is planted
+            for(size_t at : {size_t(0), n / 3, n / 2, n > 0 ? n - 1 : 0}){
+                if(at >= n) continue;
+                std::vector<T> planted = items;
+                planted[at] = T(0);
+                if(n > 1) planted[n - 1 - at / 2] = T(0);
+                const T* first = planted.data();
+                const T* last = first + n;
+                CHECK(custom::find(first, last, T(0)) == std::find(first, last, T(0)));
+                CHECK(custom::count(first, last, T(0)) == size_t(std::count(first, last, T(0))));
+            }
+            const T* first = items.data();
+            CHECK(custom::count(first, first + n, T(2)) == size_t(std::count(first, first + n, T(2))));
+            CHECK(!custom::contains(first, first + n, T(9)));
+        }
+    }
+
+    /**
+     * Floats are compared like ==: -0.0 matches 0.0, and NaN never matches anything
+    */
+    template<typename T>
+    void check_float_scan(){
+        std::vector<T> items(100, T(1.5));
+        items[37] = T(-0.0);
+        items[80] = std::numeric_limits<T>::quiet_NaN();
+        CHECK(custom::find(items.data(), items.data() + items.size(), T(0.0)) == items.data() + 37);
+        CHECK(custom::count(items.data(), items.data() + items.size(), T(-0.0)) == 1);
+        CHECK(!custom::contains(items.data(), items.data() + items.size(), std::numeric_limits<T>::quiet_NaN()));
+        CHECK(custom::count(items.data(), items.data() + items.size(), T(1.5)) == 98);
+    }
+
+    void check_sorted_search(std::mt19937& rng){
+        for(size_t n : {0, 1, 2, 3, 15, 16, 17, 1000, 4095, 100000}){
+            std::vector<int> items(n);
+            for(int& item : items) item = int(rng() % (2 * n + 1)) * 2; //Even, so odd probes fall between items
+            custom::sort(items.begin(), items.end());
+            custom::eytzingerIndex<int> index(items.begin(), items.end());
+            CHECK(index.size() == n);
+            bool agree = true;
+            for(int probe = -1; probe <= int(4 * n + 3); probe += n > 1000 ? 97 : 1){
+                const auto expected = std::lower_bound(items.begin(), items.end(), probe);
+                agree &= custom::branchless_lower_bound(items.begin(), items.end(), probe) == expected;
+                agree &= custom::branchless_binary_search(items.begin(), items.end(), probe) == std::binary_search(items.begin(), items.end(), probe);
+                const int* found = index.lower_bound(probe);
+                agree &= expected == items.end() ? found == nullptr : (found && *found == *expected);
+                agree &= index.contains(probe) == std::binary_search(items.begin(), items.end(), probe);
+            }
+            CHECK(agree);
+        }
+    }
+
+    void check_myVector_search(){
+        custom::myVector<int> v;
+        for(int i = 0; i < 1000; ++i) v.push_back(i % 100);
+        CHECK(v.contains(42) && !v.contains(100) && v.count(42) == 10);
+        CHECK(v.find<custom::myIterator<int>>(42) == v.begin() + 42 && v.find<custom::myIterator<int>>(100) == custom::myIterator<int>()); //Not found is a null iterator
+    }
+}
+
+int main(){
+    std::mt19937 rng(18);
+    check_scan<int8_t>(rng);
+    check_scan<int16_t>(rng);
+    check_scan<int32_t>(rng);
+    check_scan<uint64_t>(rng);
+    check_scan<float>(rng);
+    check_scan<double>(rng);
+    check_float_scan<float>();
+    check_float_scan<double>();
+    check_sorted_search(rng);
+    check_myVector_search();
+    return testing::finish("searchTests");
+}
@@ -0,0 +1,64 @@
+#include <algorithm>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+#include "soaVector.hpp"
+#include "testing.hpp"
+
+/**
+ * Checks that soaVector keeps the fields of each row together, through sort_by on every column type and the row-wise operations,
+ * against a std::vector of tuples sorted with std::stable_sort
+*/
+namespace{
+    using row = std::tuple<int, double, std::string>;
+
+    bool same(const custom::soaVector<int, double, std::string>& table, const std::vector<row>& expected){
+        if(table.size() != expected.size()) return false;
+        for(size_t i = 0; i < expected.size(); ++i){
+            if(row(table.row(i)) != expected[i]) return false;
+        }
+        return true;
+    }
+
+    template<size_t Column>
+    void check_sort_by(custom::soaVector<int, double, std::string> table, std::vector<row> expected){
+        table.sort_by<Column>();
+        std::stable_sort(expected.begin(), expected.end(), [](const row& a, const row& b){ return std::get<Column>(a) < std::get<Column>(b); });
+        CHECK(same(table, expected));
+    }
+
+    void check_soaVector(){
+        std::mt19937 rng(20);
+        custom::soaVector<int, double, std::string> table;
+        std::vector<row> expected;
+        for(int i = 0; i < 5000; ++i){ //Few distinct keys, so stability matters, and negative ints for the packed path
+            const int key = int(rng() % 50) - 25;
+            const double value = double(rng() % 100) / 4;
+            table.push_back(key, value, std::to_string(i % 300));
+            expected.emplace_back(key, value, std::to_string(i % 300));
+        }
+        CHECK(same(table, expected));
+        check_sort_by<0>(table, expected);
+        check_sort_by<1>(table, expected);
+        check_sort_by<2>(table, expected);
+
+        table.push_back(row{7, 0.5, "x"});
+        table.pop_back();
+        CHECK(same(table, expected));
+        table.column<0>()[0] = 1000;
+        std::get<0>(expected[0]) = 1000;
+        CHECK(same(table, expected) && table.column<2>().size() == table.size());
+
+        table.resize(10);
+        expected.resize(10);
+        CHECK(same(table, expected));
+        table.clear();
+        CHECK(table.size() == 0 && table.column<1>().empty());
+    }
+}
+
+int main(){
+    check_soaVector();
+    return testing::finish("soaVectorTests");
+}
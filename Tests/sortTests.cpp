@@ -0,0 +1,149 @@
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
+#include "sort.hpp"
+#include "stableSort.hpp"
+#include "testing.hpp"
+
+/**
+ * Checks that the sorts return a sorted permutation of their input, at sizes that reach every path through custom::sort:
+ * insertion sort and the SIMD sorting networks for small partitions, introsort, and the radix sort from 1024 items up.
+ * Floats are compared by bit pattern, so a -0.0 turning into +0.0 (or a NaN being duplicated) counts as a failure
+*/
+namespace{
+    template<typename T>
+    auto bits_of(T value){
+        if constexpr (std::is_floating_point_v<T>) return std::bit_cast<std::conditional_t<sizeof(T) == 4, uint32_t, uint64_t>>(value);
+        else return value;
+    }
+
+    template<typename T>
+    bool same_items(const std::vector<T>& a, const std::vector<T>& b){
+        std::vector<decltype(bits_of(T()))> x, y;
+        for(const T& item : a) x.push_back(bits_of(item));
+        for(const T& item : b) y.push_back(bits_of(item));
+        std::sort(x.begin(), x.end());
+        std::sort(y.begin(), y.end());
+        return x == y;
+    }
+
+    template<typename T>
+    bool sorted(const std::vector<T>& items){
+        return std::is_sorted(items.begin(), items.end());
+    }
+
+    /**
+     * Floats drawn from a handful of values, so blocks are full of ties, including both zeros
+    */
+    template<typename T>
+    std::vector<T> signed_zeros(size_t n, std::mt19937& rng){
+        const T values[] = {T(-0.0), T(0.0), T(-1.5), T(2.0), -std::numeric_limits<T>::infinity(), std::numeric_limits<T>::infinity(), T(-0.0), T(0.0)};
+        std::vector<T> items(n);
+        for(T& item : items) item = values[rng() % 8];
+        return items;
+    }
+
+    template<typename T, class Sort>
+    void check_floats(Sort sort, std::mt19937& rng){
+        for(size_t n : {2, 7, 16, 31, 40, 64, 100, 257, 1000, 1023, 1024, 5000, 100000}){
+            std::vector<T> input = signed_zeros<T>(n, rng);
+            std::vector<T> items = input;
+            sort(items);
+            CHECK(same_items(items, input));
+            CHECK(sorted(items));
+
+            std::vector<T> alternating(n); //The case that used to lose the negative zeros
+            for(size_t i = 0; i < n; ++i) alternating[i] = i % 2 ? T(0.0) : T(-0.0);
+            items = alternating;
+            sort(items);
+            CHECK(same_items(items, alternating));
+
+            std::uniform_real_distribution<T> dist(-1000, 1000);
+            input.clear();
+            for(size_t i = 0; i < n; ++i) input.push_back(i % 5 == 0 ? std::copysign(T(0), dist(rng)) : dist(rng));
+            items = input;
+            sort(items);
+            CHECK(same_items(items, input));
+            CHECK(sorted(items));
+
+            //NaN has no place in operator<'s order, so the result can't be checked for order, but no item may be lost or duplicated
+            input[rng() % n] = std::numeric_limits<T>::quiet_NaN();
+            input[rng() % n] = -std::numeric_limits<T>::quiet_NaN();
+            items = input;
+            sort(items);
+            CHECK(same_items(items, input));
+        }
+    }
+
+    template<typename T, class Sort>
+    void check_integers(Sort sort, std::mt19937& rng){
+        for(size_t n : {0, 1, 2, 15, 16, 63, 64, 65, 500, 1024, 70000}){
+            std::vector<T> input(n);
+            for(T& item : input) item = T(rng()) % 100 - 50; //Lots of duplicates and negatives
+            std::vector<T> items = input;
+            sort(items);
+            CHECK(same_items(items, input));
+            CHECK(sorted(items));
+        }
+    }
+
+    /**
+     * Calls the sorting network kernels directly, so they are tested even where custom::sort would pick another path
+    */
+    template<typename T>
+    void check_network(std::mt19937& rng){
+        const detail::network_kernel<T>* kernel = detail::network_kernel_for<T>();
+        if(!kernel) return;
+        for(std::ptrdiff_t n = 1; n <= kernel->block; ++n){
+            std::vector<T> input = signed_zeros<T>(size_t(n), rng);
+            std::vector<T> items = input;
+            CHECK(kernel->sort(items.data(), items.data() + n));
+            CHECK(same_items(items, input));
+            CHECK(std::is_sorted(items.begin(), items.end(), [](T a, T b){ return detail::network_key(a) < detail::network_key(b); })); //-0.0 before +0.0
+
+            if constexpr (std::is_floating_point_v<T>){
+                items[size_t(n) / 2] = std::numeric_limits<T>::quiet_NaN();
+                input = items;
+                CHECK(!kernel->sort(items.data(), items.data() + n)); //Refused, and left alone
+                CHECK(std::equal(items.begin(), items.end(), input.begin(), [](T a, T b){ return bits_of(a) == bits_of(b); }));
+            }
+        }
+    }
+
+    template<typename T>
+    void check_all_sorts(std::mt19937& rng){
+        auto introsort = [](std::vector<T>& v){ custom::sort(v.data(), v.data() + v.size()); };
+        auto pdqsort = [](std::vector<T>& v){ custom::pdq_sort(v.begin(), v.end()); };
+        auto stable = [](std::vector<T>& v){ custom::stable_sort(v.begin(), v.end()); };
+        auto parallel = [](std::vector<T>& v){ custom::sort(custom::execution::par, v.begin(), v.end()); };
+        if constexpr (std::is_floating_point_v<T>){
+            check_floats<T>(introsort, rng);
+            check_floats<T>(pdqsort, rng);
+            check_floats<T>(stable, rng);
+            check_floats<T>(parallel, rng);
+        }
+        else{
+            check_integers<T>(introsort, rng);
+            check_integers<T>(pdqsort, rng);
+            check_integers<T>(stable, rng);
+            check_integers<T>(parallel, rng);
+        }
+    }
+}
+
+int main(){
+    std::mt19937 rng(12345);
+    check_all_sorts<float>(rng);
+    check_all_sorts<double>(rng);
+    check_all_sorts<int32_t>(rng);
+    check_all_sorts<int64_t>(rng);
+    check_network<float>(rng);
+    check_network<double>(rng);
+    check_network<int32_t>(rng);
+    check_network<int64_t>(rng);
+    return testing::finish("sortTests");
+}
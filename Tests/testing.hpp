@@ -0,0 +1,26 @@
+#ifndef CUSTOM_TESTING
+#define CUSTOM_TESTING
+#include <cstdio>
+
+/**
+ * The smallest possible test harness: CHECK prints every failed condition with its line, and main returns finish(),
+ * which is non-zero if anything failed, so ctest reports the executable as failed
+*/
+namespace testing{
+    inline int failures = 0;
+
+    inline void check(bool passed, const char* condition, const char* file, int line){
+        if(passed) return;
+        ++failures;
+        std::fprintf(stderr, "%s:%d: check failed: %s\n", file, line, condition);
+    }
+
+    inline int finish(const char* suite){
+        if(failures == 0) std::printf("%s: all checks passed\n", suite);
+        else std::printf("%s: %d checks failed\n", suite, failures);
+        return failures == 0 ? 0 : 1;
+    }
+}
+
+#define CHECK(condition) testing::check(bool(condition), #condition, __FILE__, __LINE__)
+#endif //CUSTOM_TESTING
@@ -0,0 +1,61 @@
+#include <string>
+#include "myVector.hpp"
+#include "testing.hpp"
+
+/**
+ * Checks what myVector's instrumentation counts. Built with CUSTOM_VECTOR_STATS (see CMakeLists.txt), since without it the counters don't exist
+*/
+static_assert(detail::vector_stats, "vectorStatsTests has to be built with CUSTOM_VECTOR_STATS");
+
+namespace{
+    using doubling = custom::myVector<int, std::allocator<int>, 0, custom::geometricGrowth<2, 1, 0>>;
+
+    /**
+     * Doubling from empty to 100 ints reallocates to 1, 2, 4, ..., 128, carrying over 1 + 2 + ... + 64 objects
+    */
+    void check_growth_counts(){
+        doubling::reset_type_stats();
+        doubling v;
+        for(int i = 0; i < 100; ++i) v.push_back(i);
+        const custom::vectorStats& stats = v.stats();
+        CHECK(stats.reallocations == 8);
+        CHECK(stats.bytes_allocated == 255 * sizeof(int));
+        CHECK(stats.bytes_freed == 127 * sizeof(int));
+        CHECK(stats.elements_moved == 127 && stats.elements_copied == 0);
+        CHECK(stats.peak_slack == 64);
+
+        v.erase(v.begin(), v.begin() + 10); //90 objects shift forward
+        CHECK(v.stats().elements_moved == 127 + 90);
+        v.reset_stats();
+        CHECK(v.stats().reallocations == 0 && v.stats().elements_moved == 0);
+
+        doubling w;
+        for(int i = 0; i < 3; ++i) w.push_back(i);
+        const custom::vectorStats totals = doubling::type_stats(); //Both vectors, including what v counted before its reset
+        CHECK(totals.reallocations == 8 + 3 && totals.bytes_allocated == (255 + 7) * sizeof(int));
+    }
+
+    struct throwingMove{
+        std::string value;
+        throwingMove(const char* v) : value(v) {}
+        throwingMove(const throwingMove& other) : value(other.value) {}
+        throwingMove(throwingMove&& other) noexcept(false) : value(std::move(other.value)) {}
+        throwingMove& operator=(const throwingMove&) = default;
+    };
+
+    /**
+     * Growth carries objects over with move_if_noexcept, so objects whose move can throw are counted as copies
+    */
+    void check_copies(){
+        custom::myVector<throwingMove> v;
+        for(int i = 0; i < 10; ++i) v.push_back("x");
+        CHECK(v.stats().elements_copied > 0 && v.stats().elements_moved == 0);
+        CHECK(v.stats().bytes_allocated - v.stats().bytes_freed == v.capacity() * sizeof(throwingMove));
+    }
+}
+
+int main(){
+    check_growth_counts();
+    check_copies();
+    return testing::finish("vectorStatsTests");
+}